@@ -136,6 +136,52 @@ BOOST_AUTO_TEST_SUITE(LiebmannBench)
         }
     };
 
+/// Benchmark for the Jacobi sweeps of the pixel phase
+    template<typename T>
+    class benchJacobiSweeps {
+    protected:
+        /// Jacobi iterations made on each evaluation
+        const size_t _sweeps;
+
+        /// Iterations advanced per tile, 1 sweeps the whole plate each time
+        const size_t _tileIterations;
+
+        /// State of the benchmarked evaluation
+        anpi::Matrix<T> _plate;
+        anpi::Matrix<T> _lastIteration;
+        anpi::StencilWeights<T> _weights;
+    public:
+        /// Construct
+        benchJacobiSweeps(const size_t sweeps, const size_t tileIterations)
+                : _sweeps(sweeps), _tileIterations(tileIterations) {
+
+            _weights = anpi::isolationWeights<T>(std::vector<bool>{false, false, false, false});
+        }
+
+        /// Prepare a square plate of the given size
+        void prepare(const size_t size) {
+            _plate = anpi::Matrix<T>(size + 2, size + 2, T(0));
+            _plate.fillRow(250, 0);
+            _plate.fillRow(125, size + 1);
+            _lastIteration = _plate;
+        }
+
+        // Evaluate the sweeps, the matrix is streamed once per tileIterations
+        inline void eval() {
+            for (size_t k = 0; k < _sweeps; k += _tileIterations) {
+                _lastIteration = _plate;
+
+                if (_tileIterations > 1) {
+                    anpi::temporalBlockedJacobi(_plate, _lastIteration, _weights, T(1), _tileIterations);
+                } else {
+                    for (size_t i = 1; i < _plate.rows() - 1; ++i) {
+                        anpi::aimpl::stencilRow(_plate, _lastIteration, i, _weights, T(1));
+                    }
+                }
+            }
+        }
+    };
+
 /**
  * Instantiate and test the methods of the Matrix class
  */
@@ -191,4 +237,47 @@ BOOST_AUTO_TEST_SUITE(LiebmannBench)
         ::anpi::benchmark::show();
     }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+/**
+ * Time of 16 Jacobi iterations with and without temporal blocking. Without
+ * blocking the plate is copied and swept 16 times, with blocking it goes
+ * through memory 16 / tileIterations times.
+ */
+    BOOST_AUTO_TEST_CASE(TemporalBlockingBenchmark) {
+
+        std::vector<size_t> sizes = {256, 512, 1024, 2048, 4096};
+
+        const size_t sweeps = 16;
+        const size_t repetitions = 5;
+        std::vector<anpi::benchmark::measurement> times;
+
+        {
+            benchJacobiSweeps<double> bjs(sweeps, 1);
+
+            ANPI_BENCHMARK(sizes, repetitions, times, bjs);
+
+            ::anpi::benchmark::write("Jacobi_double_untiled.txt", times);
+            ::anpi::benchmark::plotRange(times, "Sin bloqueo", "r");
+        }
+
+        {
+            benchJacobiSweeps<double> bjs(sweeps, 4);
+
+            ANPI_BENCHMARK(sizes, repetitions, times, bjs);
+
+            ::anpi::benchmark::write("Jacobi_double_tile4.txt", times);
+            ::anpi::benchmark::plotRange(times, "4 iteraciones por bloque", "g");
+        }
+
+        {
+            benchJacobiSweeps<double> bjs(sweeps, 16);
+
+            ANPI_BENCHMARK(sizes, repetitions, times, bjs);
+
+            ::anpi::benchmark::write("Jacobi_double_tile16.txt", times);
+            ::anpi::benchmark::plotRange(times, "16 iteraciones por bloque", "b");
+        }
+
+        ::anpi::benchmark::show();
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
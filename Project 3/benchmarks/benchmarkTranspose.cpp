@@ -0,0 +1,188 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#include <boost/test/unit_test.hpp>
+
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+
+/**
+ * Benchmarks for the transposition of matrices
+ */
+#include "benchmarkFramework.hpp"
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+
+BOOST_AUTO_TEST_SUITE( Transpose )
+
+/// Benchmark for transposition operations
+template<typename T>
+class benchTranspose {
+protected:
+  /// Maximum allowed size for the square matrices
+  const size_t _maxSize;
+
+  /// A large matrix holding the data to be transposed
+  anpi::Matrix<T> _data;
+
+  /// State of the benchmarked evaluation
+  anpi::Matrix<T> _a;
+  anpi::Matrix<T> _c;
+public:
+  /// Construct
+  benchTranspose(const size_t maxSize)
+    : _maxSize(maxSize),_data(maxSize,maxSize,anpi::DoNotInitialize) {
+
+    size_t idx=0;
+    for (size_t r=0;r<_maxSize;++r) {
+      for (size_t c=0;c<_maxSize;++c) {
+        _data(r,c)=idx++;
+      }
+    }
+  }
+
+  /// Prepare the evaluation of given size
+  void prepare(const size_t size) {
+    assert (size<=this->_maxSize);
+    this->_a=std::move(anpi::Matrix<T>(size,size,_data.data()));
+    this->_c.allocate(size,size);
+  }
+};
+
+/// Column-wise transposition, as made before the blocked kernels
+template<typename T>
+class benchTransposeNaive : public benchTranspose<T> {
+public:
+  /// Constructor
+  benchTransposeNaive(const size_t n) : benchTranspose<T>(n) { }
+
+  // Evaluate on-copy transposition
+  inline void eval() {
+    const size_t n=this->_a.rows();
+    for (size_t i=0;i<n;++i) {
+      for (size_t j=0;j<n;++j) {
+        this->_c(i,j)=this->_a(j,i);
+      }
+    }
+  }
+};
+
+/// Provide the evaluation method for the blocked on-copy transposition
+template<typename T>
+class benchTransposeOnCopyFallback : public benchTranspose<T> {
+public:
+  /// Constructor
+  benchTransposeOnCopyFallback(const size_t n) : benchTranspose<T>(n) { }
+
+  // Evaluate on-copy transposition
+  inline void eval() {
+    anpi::fallback::transpose(this->_a,this->_c);
+  }
+};
+
+/// Provide the evaluation method for the SIMD on-copy transposition
+template<typename T>
+class benchTransposeOnCopySIMD : public benchTranspose<T> {
+public:
+  /// Constructor
+  benchTransposeOnCopySIMD(const size_t n) : benchTranspose<T>(n) { }
+
+  // Evaluate on-copy transposition
+  inline void eval() {
+    anpi::simd::transpose(this->_a,this->_c);
+  }
+};
+
+/// Provide the evaluation method for the SIMD in-place transposition
+template<typename T>
+class benchTransposeInPlaceSIMD : public benchTranspose<T> {
+public:
+  /// Constructor
+  benchTransposeInPlaceSIMD(const size_t n) : benchTranspose<T>(n) { }
+
+  // Evaluate in-place transposition
+  inline void eval() {
+    anpi::simd::transpose(this->_a);
+  }
+};
+
+/**
+ * Compare the column-wise transposition with the blocked ones
+ */
+BOOST_AUTO_TEST_CASE( Transposition ) {
+
+  std::vector<size_t> sizes = {  24,  32,  48,  64,
+                                 96, 128, 192, 256,
+                                384, 512, 768,1024,
+                               1536,2048,3072,4096};
+
+  const size_t n=sizes.back();
+  const size_t repetitions=20;
+  std::vector<anpi::benchmark::measurement> times;
+
+  {
+    benchTransposeNaive<double> btn(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,btn);
+
+    ::anpi::benchmark::write("transpose_double_naive.txt",times);
+    ::anpi::benchmark::plotRange(times,"Column-wise (double)","r");
+  }
+
+  {
+    benchTransposeOnCopyFallback<double> btf(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,btf);
+
+    ::anpi::benchmark::write("transpose_double_fb.txt",times);
+    ::anpi::benchmark::plotRange(times,"Blocked (double) fallback","b");
+  }
+
+  {
+    benchTransposeOnCopySIMD<double> bts(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bts);
+
+    ::anpi::benchmark::write("transpose_double_simd.txt",times);
+    ::anpi::benchmark::plotRange(times,"Blocked (double) simd","g");
+  }
+
+  {
+    benchTransposeInPlaceSIMD<double> bti(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bti);
+
+    ::anpi::benchmark::write("transpose_in_place_double_simd.txt",times);
+    ::anpi::benchmark::plotRange(times,"In-place (double) simd","m");
+  }
+
+  {
+    benchTransposeNaive<float> btn(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,btn);
+
+    ::anpi::benchmark::write("transpose_float_naive.txt",times);
+    ::anpi::benchmark::plotRange(times,"Column-wise (float)","k");
+  }
+
+  {
+    benchTransposeOnCopySIMD<float> bts(n);
+
+    ANPI_BENCHMARK(sizes,repetitions,times,bts);
+
+    ::anpi::benchmark::write("transpose_float_simd.txt",times);
+    ::anpi::benchmark::plotRange(times,"Blocked (float) simd","c");
+  }
+
+  ::anpi::benchmark::show();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
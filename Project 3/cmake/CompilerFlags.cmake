@@ -23,7 +23,7 @@ elseif (CMAKE_COMPILER_IS_GNUCC OR CMAKE_COMPILER_IS_GNUCXX)
 endif ()
 
 if (ANPI_ENABLE_SIMD)
-    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS}  -mavx2")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS}  -mavx2 -mfma")
 endif()
 
 set(CMAKE_CXX_FLAGS_DEBUG "-g")
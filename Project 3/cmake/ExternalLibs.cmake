@@ -17,6 +17,14 @@ if (ANPI_ENABLE_OpenMP)
   endif()
 endif (ANPI_ENABLE_OpenMP)
 
+## The ranks of the domain decomposed solver run as threads on one machine
+find_package(Threads REQUIRED)
+
+if (ANPI_ENABLE_MPI)
+  find_package(MPI REQUIRED)
+  include_directories(${MPI_CXX_INCLUDE_PATH})
+endif (ANPI_ENABLE_MPI)
+
 find_package(OpenCV REQUIRED)
 
 include_directories (${CMAKE_SOURCE_DIR}/include
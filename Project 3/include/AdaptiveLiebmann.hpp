@@ -0,0 +1,791 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_ADAPTIVE_LIEBMANN_H
+#define ANPI_ADAPTIVE_LIEBMANN_H
+
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "Matrix.hpp"
+#include "Exception.hpp"
+#include "Liebmann.hpp"
+#include "ParallelOptions.hpp"
+
+namespace anpi {
+
+    /**
+     * Parameters of the adaptive refinement of the plate
+     */
+    struct AdaptiveOptions {
+        /// Halvings of the whole plate made before the first solve
+        size_t initialLevels = 4;
+
+        /// Largest temperature difference between neighbouring cells, or along the border of a cell, left unrefined
+        double threshold = 1;
+
+        /// Fraction of the threshold above which the cells are divided once a pass finds a cell above it
+        double refineFraction = 0.75;
+
+        /// Maximum number of refinement passes, each one solves the cells again
+        size_t maxPasses = 64;
+
+        /// Euclidean norm of the residual of the cells relative to the one of the border terms accepted as converged
+        double tolerance = 1e-8;
+
+        /// Maximum number of conjugate gradient iterations on each pass
+        size_t maxIterations = 100000;
+
+        /// If not null, receives the number of cells solved on each pass
+        std::vector<size_t> *cellHistory = nullptr;
+
+        /// Threads and schedule of the OpenMP regions
+        ParallelOptions parallel;
+    };
+
+
+    namespace amrimpl {
+
+        /// Marks a face that lies on the border of the plate
+        constexpr size_t none = std::numeric_limits<size_t>::max();
+
+        /**
+         * Cell of the quadtree, a block of inner pixels [iStart, iEnd) x
+         * [jStart, jEnd). The children of a cell are stored together, and
+         * firstChild is zero on the leaves since the root is never a child
+         */
+        struct Cell {
+            size_t iStart, iEnd, jStart, jEnd;
+            size_t depth;
+            size_t firstChild;
+            size_t children;
+
+            /// Whether the cell has no children
+            inline bool isLeaf() const {
+                return firstChild == 0;
+            }
+
+            /// Whether the cell is larger than a pixel
+            inline bool canSplit() const {
+                return (iEnd - iStart > 1) || (jEnd - jStart > 1);
+            }
+        };
+
+
+        /**
+         * Quadtree over the inner pixels of the plate. A cell is divided by
+         * half on each side, as the chunks of liebmannAux, and a side of a
+         * single pixel is left whole. Each cell keeps the temperature of its
+         * center.
+         *
+         * @tparam T    :   Data type
+         */
+        template<typename T>
+        class Quadtree {
+        public:
+            /// Cells of the tree, the root is the first one
+            std::vector<Cell> cells;
+
+            /// Temperature at the center of each cell
+            std::vector<T> value;
+
+            /**
+             * Tree of a single cell covering the plate
+             *
+             * @param rows      : Inner rows of the plate
+             * @param cols      : Inner columns of the plate
+             * @param initial   : Temperature of the root
+             */
+            Quadtree(const size_t rows, const size_t cols, const T initial) {
+                cells.push_back(Cell{0, rows, 0, cols, 0, 0, 0});
+                value.push_back(initial);
+            }
+
+            /// Inner rows of the plate
+            inline size_t rows() const {
+                return cells[0].iEnd;
+            }
+
+            /// Inner columns of the plate
+            inline size_t cols() const {
+                return cells[0].jEnd;
+            }
+
+            /// Row of the center of a cell, in pixels
+            inline T row(const size_t c) const {
+                return T(cells[c].iStart + cells[c].iEnd - 1) / 2;
+            }
+
+            /// Column of the center of a cell, in pixels
+            inline T column(const size_t c) const {
+                return T(cells[c].jStart + cells[c].jEnd - 1) / 2;
+            }
+
+            /**
+             * Divides a leaf in up to four children, which start with its
+             * temperature
+             *
+             * @param c     : Leaf to divide
+             */
+            void split(const size_t c) {
+                const Cell parent = cells[c];
+                const size_t iCuts[3] = {parent.iStart, parent.iStart + (parent.iEnd - parent.iStart) / 2, parent.iEnd};
+                const size_t jCuts[3] = {parent.jStart, parent.jStart + (parent.jEnd - parent.jStart) / 2, parent.jEnd};
+
+                const size_t first = cells.size();
+                for (size_t a = 0; a < 2; ++a) {
+                    for (size_t b = 0; b < 2; ++b) {
+                        if (iCuts[a] != iCuts[a + 1] && jCuts[b] != jCuts[b + 1]) {
+                            cells.push_back(Cell{iCuts[a], iCuts[a + 1], jCuts[b], jCuts[b + 1], parent.depth + 1, 0, 0});
+                            value.push_back(value[c]);
+                        }
+                    }
+                }
+
+                cells[c].firstChild = first;
+                cells[c].children = cells.size() - first;
+            }
+
+            /**
+             * Leaves of the tree
+             *
+             * @param out   : Receives the index of each leaf
+             */
+            void leaves(std::vector<size_t> &out) const {
+                out.clear();
+                for (size_t c = 0; c < cells.size(); ++c) {
+                    if (cells[c].isLeaf()) {
+                        out.push_back(c);
+                    }
+                }
+            }
+
+            /**
+             * Leaves that share pixels with the block [iStart, iEnd) x [jStart, jEnd)
+             *
+             * @param out   : Receives the index of each leaf
+             */
+            void collect(const size_t iStart,
+                         const size_t iEnd,
+                         const size_t jStart,
+                         const size_t jEnd,
+                         std::vector<size_t> &out) const {
+
+                out.clear();
+                std::vector<size_t> pending(1, 0);
+
+                while (!pending.empty()) {
+                    const Cell &cell = cells[pending.back()];
+                    const size_t c = pending.back();
+                    pending.pop_back();
+
+                    if (cell.iEnd <= iStart || cell.iStart >= iEnd || cell.jEnd <= jStart || cell.jStart >= jEnd) {
+                        continue;
+                    }
+                    if (cell.isLeaf()) {
+                        out.push_back(c);
+                    } else {
+                        for (size_t k = 0; k < cell.children; ++k) {
+                            pending.push_back(cell.firstChild + k);
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Leaves across one side of a cell, there are none on the border
+             * of the plate
+             *
+             * @param c     : Cell
+             * @param side  : Side of the cell. Convention used: {top; bot; left; right}
+             * @param out   : Receives the index of each leaf
+             */
+            void neighbours(const size_t c, const size_t side, std::vector<size_t> &out) const {
+                const Cell cell = cells[c];
+                out.clear();
+
+                switch (side) {
+                    case 0:
+                        if (cell.iStart > 0) {
+                            collect(cell.iStart - 1, cell.iStart, cell.jStart, cell.jEnd, out);
+                        }
+                        break;
+                    case 1:
+                        if (cell.iEnd < rows()) {
+                            collect(cell.iEnd, cell.iEnd + 1, cell.jStart, cell.jEnd, out);
+                        }
+                        break;
+                    case 2:
+                        if (cell.jStart > 0) {
+                            collect(cell.iStart, cell.iEnd, cell.jStart - 1, cell.jStart, out);
+                        }
+                        break;
+                    default:
+                        if (cell.jEnd < cols()) {
+                            collect(cell.iStart, cell.iEnd, cell.jEnd, cell.jEnd + 1, out);
+                        }
+                        break;
+                }
+            }
+        };
+
+
+        /**
+         * Face between a cell and a neighbouring leaf, or the border of the plate
+         *
+         * @tparam T    :   Data type
+         */
+        template<typename T>
+        struct Face {
+            /// Unknown of the neighbouring leaf, none on the border
+            size_t neighbour;
+            /// Side of the cell. Convention used: {top; bot; left; right}
+            size_t side;
+            /// Pixels shared by both sides of the face
+            T length;
+            /// Distance between the centers, or from the center to the border line
+            T distance;
+            /// Average of the border pixels along the face
+            T value;
+            /// Difference between the largest and smallest border pixel along the face
+            T spread;
+        };
+
+
+        /**
+         * Finite volume equations of the leaves of the tree: the heat leaving
+         * a cell through a face is its length times the difference of
+         * temperatures over the distance between the centers. On a tree of
+         * single pixels they are the 5-point stencil of the Liebmann method.
+         *
+         * @tparam T    :   Data type
+         */
+        template<typename T>
+        struct CellSystem {
+            /// Tree cell of each unknown
+            std::vector<size_t> leaves;
+            /// First face of each unknown, the last entry is the number of faces
+            std::vector<size_t> start;
+            /// Faces of all the unknowns
+            std::vector<Face<T> > faces;
+            /// Sum of the coefficients of the faces of each unknown
+            std::vector<T> diagonal;
+            /// Heat entering each unknown from the border
+            std::vector<T> rhs;
+        };
+
+
+        /**
+         * Builds the equations of the current leaves of the tree
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param tree      : Quadtree over the inner pixels
+         * @param plate     : Plate whose border lines are the frontier conditions
+         * @param system    : Equations of the leaves, rebuilt
+         */
+        template<typename T, class Alloc>
+        void assemble(const Quadtree<T> &tree,
+                      const anpi::Matrix<T, Alloc> &plate,
+                      CellSystem<T> &system) {
+
+            tree.leaves(system.leaves);
+            const size_t n = system.leaves.size();
+
+            std::vector<size_t> unknown(tree.cells.size(), none);
+            for (size_t a = 0; a < n; ++a) {
+                unknown[system.leaves[a]] = a;
+            }
+
+            system.start.assign(1, 0);
+            system.faces.clear();
+            system.diagonal.assign(n, T(0));
+            system.rhs.assign(n, T(0));
+
+            std::vector<size_t> across;
+
+            for (size_t a = 0; a < n; ++a) {
+                const size_t c = system.leaves[a];
+                const Cell cell = tree.cells[c];
+                const T y = tree.row(c);
+                const T x = tree.column(c);
+
+                for (size_t side = 0; side < 4; ++side) {
+                    const bool vertical = side < 2;
+                    tree.neighbours(c, side, across);
+
+                    for (const size_t b : across) {
+                        const Cell &other = tree.cells[b];
+                        const T length = vertical ?
+                                         T(std::min(cell.jEnd, other.jEnd) - std::max(cell.jStart, other.jStart)) :
+                                         T(std::min(cell.iEnd, other.iEnd) - std::max(cell.iStart, other.iStart));
+                        const T distance = vertical ? std::abs(tree.row(b) - y) : std::abs(tree.column(b) - x);
+
+                        system.faces.push_back(Face<T>{unknown[b], side, length, distance, T(0), T(0)});
+                        system.diagonal[a] += length / distance;
+                    }
+
+                    if (!across.empty()) {
+                        continue;
+                    }
+
+                    // The border lines are the rows 0 and rows + 1 and the
+                    // columns 0 and cols + 1 of the plate
+                    T sum = T(0);
+                    T smallest = std::numeric_limits<T>::max();
+                    T largest = std::numeric_limits<T>::lowest();
+                    const size_t first = vertical ? cell.jStart : cell.iStart;
+                    const size_t last = vertical ? cell.jEnd : cell.iEnd;
+
+                    for (size_t k = first; k < last; ++k) {
+                        const T pixel = (side == 0) ? plate(0, k + 1) :
+                                        (side == 1) ? plate(tree.rows() + 1, k + 1) :
+                                        (side == 2) ? plate(k + 1, 0) :
+                                        plate(k + 1, tree.cols() + 1);
+                        sum += pixel;
+                        smallest = std::min(smallest, pixel);
+                        largest = std::max(largest, pixel);
+                    }
+
+                    const T length = T(last - first);
+                    const T distance = (side == 0) ? y + 1 :
+                                       (side == 1) ? T(tree.rows()) - y :
+                                       (side == 2) ? x + 1 :
+                                       T(tree.cols()) - x;
+
+                    system.faces.push_back(Face<T>{none, side, length, distance, sum / length, largest - smallest});
+                    system.diagonal[a] += length / distance;
+                    system.rhs[a] += sum / distance;
+                }
+
+                system.start.push_back(system.faces.size());
+            }
+        }
+
+
+        /**
+         * Product q = A p of the equations of the leaves
+         *
+         * @tparam T        : Data type
+         * @param system    : Equations of the leaves
+         * @param p         : Temperature of each unknown
+         * @param q         : Receives the product
+         * @param threads   : Threads used
+         * @return          : Dot product of p and q
+         */
+        template<typename T>
+        T apply(const CellSystem<T> &system,
+                const std::vector<T> &p,
+                std::vector<T> &q,
+                const int threads) {
+
+            const size_t n = system.leaves.size();
+            T pq = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) reduction(+ : pq)
+#endif
+            for (size_t a = 0; a < n; ++a) {
+                T sum = system.diagonal[a] * p[a];
+                for (size_t f = system.start[a]; f < system.start[a + 1]; ++f) {
+                    const Face<T> &face = system.faces[f];
+                    if (face.neighbour != none) {
+                        sum -= face.length / face.distance * p[face.neighbour];
+                    }
+                }
+                q[a] = sum;
+                pq += p[a] * sum;
+            }
+
+            return pq;
+        }
+
+
+        /**
+         * Solves the equations of the leaves with the conjugate gradient
+         * method preconditioned with the inverse of the diagonal, which
+         * differs from cell to cell on a refined tree
+         *
+         * @tparam T        : Data type
+         * @param system    : Equations of the leaves
+         * @param u         : Initial guess, overwritten with the temperature of each unknown
+         * @param options   : Tolerance, iteration limit and threads
+         * @return          : Number of iterations made
+         */
+        template<typename T>
+        size_t solve(const CellSystem<T> &system,
+                     std::vector<T> &u,
+                     const AdaptiveOptions &options) {
+
+            const size_t n = system.leaves.size();
+            const int threads = options.parallel.threadsFor(n, n);
+
+            std::vector<T> r(n), z(n), p(n), q(n);
+            apply(system, u, q, threads);
+
+            T rhsNorm = T(0);
+            T rz = T(0);
+            for (size_t a = 0; a < n; ++a) {
+                r[a] = system.rhs[a] - q[a];
+                z[a] = r[a] / system.diagonal[a];
+                p[a] = z[a];
+                rz += r[a] * z[a];
+                rhsNorm += system.rhs[a] * system.rhs[a];
+            }
+            const T limit = T(options.tolerance) * std::sqrt(rhsNorm);
+
+            size_t iterations = 0;
+            while (iterations < options.maxIterations) {
+                T rr = T(0);
+                for (size_t a = 0; a < n; ++a) {
+                    rr += r[a] * r[a];
+                }
+                if (std::sqrt(rr) <= limit) {
+                    break;
+                }
+
+                const T alpha = rz / apply(system, p, q, threads);
+                T rzNext = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) reduction(+ : rzNext)
+#endif
+                for (size_t a = 0; a < n; ++a) {
+                    u[a] += alpha * p[a];
+                    r[a] -= alpha * q[a];
+                    z[a] = r[a] / system.diagonal[a];
+                    rzNext += r[a] * z[a];
+                }
+
+                const T beta = rzNext / rz;
+                for (size_t a = 0; a < n; ++a) {
+                    p[a] = z[a] + beta * p[a];
+                }
+                rz = rzNext;
+                ++iterations;
+            }
+
+            return iterations;
+        }
+
+
+        /**
+         * Largest temperature difference around a leaf: against the leaves
+         * across its faces, against the border lines it touches and along
+         * those border lines
+         *
+         * @tparam T        : Data type
+         * @param system    : Equations of the leaves
+         * @param u         : Temperature of each unknown
+         * @param a         : Unknown
+         * @return          : Largest difference
+         */
+        template<typename T>
+        T jump(const CellSystem<T> &system,
+               const std::vector<T> &u,
+               const size_t a) {
+
+            T largest = T(0);
+            for (size_t f = system.start[a]; f < system.start[a + 1]; ++f) {
+                const Face<T> &face = system.faces[f];
+                if (face.neighbour != none) {
+                    largest = std::max(largest, std::abs(u[face.neighbour] - u[a]));
+                } else {
+                    largest = std::max(largest, std::max(std::abs(face.value - u[a]), face.spread));
+                }
+            }
+            return largest;
+        }
+
+
+        /**
+         * Divides the leaves with a neighbour more than one level deeper,
+         * so the faces of a cell are shared with at most two cells
+         *
+         * @tparam T    :   Data type
+         * @param tree  :   Quadtree over the inner pixels
+         */
+        template<typename T>
+        void balance(Quadtree<T> &tree) {
+            std::vector<size_t> leaves;
+            std::vector<size_t> across;
+            bool changed = true;
+
+            while (changed) {
+                changed = false;
+                tree.leaves(leaves);
+
+                for (const size_t c : leaves) {
+                    bool unbalanced = false;
+                    for (size_t side = 0; side < 4 && !unbalanced; ++side) {
+                        tree.neighbours(c, side, across);
+                        for (const size_t b : across) {
+                            unbalanced = unbalanced || (tree.cells[b].depth > tree.cells[c].depth + 1);
+                        }
+                    }
+
+                    if (unbalanced) {
+                        tree.split(c);
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+
+        /**
+         * Gradient of the temperature at the center of a leaf, given by the
+         * cells, or border lines, on each side of it
+         *
+         * @tparam T            : Data type
+         * @param system        : Equations of the leaves
+         * @param u             : Temperature of each unknown
+         * @param a             : Unknown
+         * @param gradientRow   : Receives the change of temperature per row
+         * @param gradientColumn: Receives the change of temperature per column
+         */
+        template<typename T>
+        void gradient(const CellSystem<T> &system,
+                      const std::vector<T> &u,
+                      const size_t a,
+                      T &gradientRow,
+                      T &gradientColumn) {
+
+            // Length weighted temperature and distance of each side
+            T value[4] = {T(0), T(0), T(0), T(0)};
+            T distance[4] = {T(0), T(0), T(0), T(0)};
+            T length[4] = {T(0), T(0), T(0), T(0)};
+
+            for (size_t f = system.start[a]; f < system.start[a + 1]; ++f) {
+                const Face<T> &face = system.faces[f];
+                const T temperature = (face.neighbour != none) ? u[face.neighbour] : face.value;
+                value[face.side] += face.length * temperature;
+                distance[face.side] += face.length * face.distance;
+                length[face.side] += face.length;
+            }
+
+            // Every side has a neighbour or a border line
+            gradientRow = (value[1] / length[1] - value[0] / length[0]) /
+                          ((distance[0] / length[0]) + (distance[1] / length[1]));
+            gradientColumn = (value[3] / length[3] - value[2] / length[2]) /
+                             ((distance[2] / length[2]) + (distance[3] / length[3]));
+        }
+
+
+        /**
+         * Divides a leaf and starts its children from the temperature of the
+         * leaf extrapolated with its gradient, which is closer to their
+         * solution than the temperature of the leaf alone
+         *
+         * @tparam T        : Data type
+         * @param tree      : Quadtree over the inner pixels
+         * @param system    : Equations of the leaves
+         * @param u         : Temperature of each unknown
+         * @param a         : Unknown of the leaf
+         */
+        template<typename T>
+        void refine(Quadtree<T> &tree,
+                    const CellSystem<T> &system,
+                    const std::vector<T> &u,
+                    const size_t a) {
+
+            const size_t c = system.leaves[a];
+            T gradientRow, gradientColumn;
+            gradient(system, u, a, gradientRow, gradientColumn);
+
+            tree.split(c);
+
+            const Cell &cell = tree.cells[c];
+            for (size_t k = cell.firstChild; k < cell.firstChild + cell.children; ++k) {
+                tree.value[k] = u[a] + gradientRow * (tree.row(k) - tree.row(c)) +
+                                gradientColumn * (tree.column(k) - tree.column(c));
+            }
+        }
+
+
+        /**
+         * Writes the leaves on the inner pixels of the plate. The temperature
+         * inside a cell is extrapolated from its center with its gradient, so
+         * a leaf of a single pixel writes its own temperature.
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param tree      : Quadtree over the inner pixels
+         * @param system    : Equations of the leaves
+         * @param u         : Temperature of each unknown
+         * @param plate     : Plate whose inner pixels are written
+         * @param parallel  : Threads and schedule of the OpenMP regions
+         */
+        template<typename T, class Alloc>
+        void reconstruct(const Quadtree<T> &tree,
+                         const CellSystem<T> &system,
+                         const std::vector<T> &u,
+                         anpi::Matrix<T, Alloc> &plate,
+                         const ParallelOptions &parallel) {
+
+            const size_t n = system.leaves.size();
+            const int threads = parallel.threadsFor(plate.rows() * plate.cols(), n);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+            for (size_t a = 0; a < n; ++a) {
+                T gradientRow, gradientColumn;
+                gradient(system, u, a, gradientRow, gradientColumn);
+
+                const size_t c = system.leaves[a];
+                const Cell &cell = tree.cells[c];
+                const T y = tree.row(c);
+                const T x = tree.column(c);
+
+                for (size_t i = cell.iStart; i < cell.iEnd; ++i) {
+                    T *row = plate[i + 1];
+                    for (size_t j = cell.jStart; j < cell.jEnd; ++j) {
+                        row[j + 1] = u[a] + gradientRow * (T(i) - y) + gradientColumn * (T(j) - x);
+                    }
+                }
+            }
+        }
+
+    } // namespace amrimpl
+
+
+    /**
+     * Solves the plate on a quadtree of cells that are only divided where
+     * the temperature changes fast. The plate starts divided by half
+     * options.initialLevels times, with the halving of the chunks of
+     * liebmannAux, and on each pass the cells are solved and every cell with
+     * a temperature difference above options.threshold against a neighbour
+     * or along the border next to it is divided again. Neighbouring cells
+     * differ by one level at most. The passes stop when no cell is divided,
+     * which happens at the latest when the divided cells reach single pixels.
+     *
+     * The cells are solved with the finite volume form of the 5-point
+     * stencil, so with a threshold of zero the result is the one of
+     * anpi::liebmann. Otherwise the temperature of the pixels inside a cell
+     * is extrapolated from its center, and the error is about a fraction of
+     * the threshold in the flat areas that are left coarse.
+     *
+     * When a border is isolated but not the opposite one the stencil only
+     * propagates values one way, which the cells do not reproduce, so the
+     * plate is solved uniformly with red-black SOR instead, with
+     * options.tolerance on the change of the pixels.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param options           : Refinement and convergence parameters
+     * @return                  : A matrix with the heat distribution given the border conditions
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> adaptiveLiebmann(anpi::Matrix<T, Alloc> &frontierConditions,
+                                            const size_t verticalLength,
+                                            const size_t horizontalLength,
+                                            const std::vector<bool> &isIsolated,
+                                            const AdaptiveOptions &options = AdaptiveOptions()) {
+
+        anpi::Matrix<T, Alloc> plate = initializePlate(frontierConditions,
+                                                       verticalLength,
+                                                       horizontalLength,
+                                                       isIsolated);
+
+        if (isIsolated.at(0) != isIsolated.at(1) || isIsolated.at(2) != isIsolated.at(3)) {
+            LiebmannOptions sorOptions;
+            sorOptions.method = LiebmannMethod::RedBlackSOR;
+            sorOptions.tolerance = options.tolerance;
+            sorOptions.maxIterations = options.maxIterations;
+            sorOptions.parallel = options.parallel;
+
+            liebmannAux(plate, isIsolated, T(1), options.parallel.isUsingOpenMP, sorOptions);
+            return plate;
+        }
+
+        amrimpl::Quadtree<T> tree(verticalLength, horizontalLength, plate(1, 1));
+        std::vector<size_t> leaves;
+
+        for (size_t level = 0; level < options.initialLevels; ++level) {
+            tree.leaves(leaves);
+            for (const size_t c : leaves) {
+                if (tree.cells[c].canSplit()) {
+                    tree.split(c);
+                }
+            }
+        }
+
+        if (options.cellHistory) {
+            options.cellHistory->clear();
+        }
+
+        amrimpl::CellSystem<T> system;
+        std::vector<T> u;
+
+        for (size_t pass = 0; pass < options.maxPasses; ++pass) {
+            amrimpl::assemble(tree, plate, system);
+
+            const size_t n = system.leaves.size();
+            u.resize(n);
+            for (size_t a = 0; a < n; ++a) {
+                u[a] = tree.value[system.leaves[a]];
+            }
+
+            amrimpl::solve(system, u, options);
+
+            for (size_t a = 0; a < n; ++a) {
+                tree.value[system.leaves[a]] = u[a];
+            }
+
+            if (options.cellHistory) {
+                options.cellHistory->push_back(n);
+            }
+
+            if (pass + 1 == options.maxPasses) {
+                break;
+            }
+
+            // The passes stop once no cell is above the threshold, but the
+            // cells are divided from a fraction of it on: a pass changes the
+            // solution a little, and it would push a few more cells over the
+            // threshold on each of the next passes
+            std::vector<T> jumps(n);
+            T largest = T(0);
+            for (size_t a = 0; a < n; ++a) {
+                jumps[a] = tree.cells[system.leaves[a]].canSplit() ? amrimpl::jump(system, u, a) : T(0);
+                largest = std::max(largest, jumps[a]);
+            }
+
+            if (largest <= T(options.threshold)) {
+                break;
+            }
+
+            for (size_t a = 0; a < n; ++a) {
+                if (jumps[a] > T(options.refineFraction * options.threshold)) {
+                    amrimpl::refine(tree, system, u, a);
+                }
+            }
+
+            amrimpl::balance(tree);
+        }
+
+        amrimpl::reconstruct(tree, system, u, plate, options.parallel);
+
+        return plate;
+    }
+
+
+} //namespace anpi
+
+
+#endif //ANPI_ADAPTIVE_LIEBMANN_H
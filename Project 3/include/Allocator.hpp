@@ -12,7 +12,16 @@
 #define ANPI_ALLOCATOR_HPP
 
 #include <boost/align/aligned_allocator.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+
 #include "HasType.hpp"
+#include "Exception.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 namespace anpi {
 
@@ -74,8 +83,197 @@ namespace anpi {
   };
 
 
+  /// Tag to map anonymous huge pages with mmap_allocator
+  enum MmapPages {
+    HugePages
+  };
+
+
+  /**
+   * Allocator that maps the memory with mmap, either from a file or from
+   * anonymous pages. A file is created if needed and resized to the
+   * allocation, so each allocation maps the whole file and a file backed
+   * allocator holds one matrix at a time. The pages of a file are only
+   * read when touched and written back by the kernel, so a matrix larger
+   * than the memory can be swept while only a window of its rows is
+   * resident.
+   *
+   * The rows are aligned as with aligned_row_allocator. Copies of the
+   * allocator share the file. Copies of matrices, their transposed copies
+   * and the results of operations on them take the allocator given by
+   * select_on_container_copy_construction instead: anonymous pages, huge
+   * if the matrix had them, so they never alias the file.
+   *
+   * The file keeps its contents when it is mapped again with the same
+   * size, so a matrix constructed with anpi::DoNotInitialize and an
+   * allocator of an existing file reads the matrix written to it,
+   * without copies, as long as the element type and alignment match.
+   *
+   * Anonymous huge pages are requested with the HugePages tag. They are
+   * taken from the reserved pool if there is one, and otherwise the
+   * mapping is advised as transparent huge pages. Their mappings are
+   * rounded to whole huge pages, so a mapping must be released by an
+   * allocator equal to the one that created it; anpi::Matrix moves and
+   * swaps its allocator together with its data for this reason.
+   */
+  template<class T, std::size_t Align=DefaultAlignment>
+  class mmap_allocator {
+  public:
+    /// Type of the elements
+    typedef T value_type;
+
+    /// Change the stored type
+    template<class U>
+    struct rebind {
+      typedef mmap_allocator<U, Align> other;
+    };
+
+    /// Type to identify this as a row-aligned allocator
+    typedef std::true_type row_aligned;
+
+    /// Anonymous pages
+    mmap_allocator() noexcept { }
+
+    /// Anonymous huge pages
+    explicit mmap_allocator(const MmapPages) noexcept : _huge(true) { }
+
+    /// Pages of the given file
+    explicit mmap_allocator(const std::string& path)
+      : _path(std::make_shared<std::string>(path)) { }
+
+    /// Same backing as another allocator
+    template<class U>
+    mmap_allocator(const mmap_allocator<U, Align>& other) noexcept
+      : _path(other.backing()), _huge(other.hugePages()) { }
+
+    /// Allocator for copies and results, the same pages without the file
+    mmap_allocator select_on_container_copy_construction() const noexcept {
+      return _huge ? mmap_allocator(HugePages) : mmap_allocator();
+    }
+
+    /// Map the memory for n elements
+    T* allocate(const std::size_t n) {
+      const std::size_t bytes = mappedBytes(n);
+      void* memory;
+
+      if (_path) {
+        const int fd = ::open(_path->c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+          throw anpi::Exception("No se pudo abrir el archivo " + *_path);
+        }
+        if (::ftruncate(fd, off_t(bytes)) != 0) {
+          ::close(fd);
+          throw anpi::Exception("No se pudo reservar espacio en el archivo " + *_path);
+        }
+        memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd); // the mapping keeps the file open
+      } else if (_huge) {
+        memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory == MAP_FAILED) {
+          // No reserved huge pages, let the kernel promote the mapping
+          memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+          if (memory != MAP_FAILED) {
+            ::madvise(memory, bytes, MADV_HUGEPAGE);
+          }
+        }
+      } else {
+        memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      }
+
+      if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      return static_cast<T*>(memory);
+    }
+
+    /// Unmap the memory of n elements, the file keeps its contents
+    void deallocate(T* p, const std::size_t n) noexcept {
+      ::munmap(p, mappedBytes(n));
+    }
+
+    /// Ask the kernel to start reading the pages of n elements
+    void prefetch(const T* p, const std::size_t n) const noexcept {
+      const std::uintptr_t first = pageFloor(reinterpret_cast<std::uintptr_t>(p));
+      const std::uintptr_t last = pageCeil(reinterpret_cast<std::uintptr_t>(p + n));
+      if (last > first) {
+        ::madvise(reinterpret_cast<void*>(first), last - first, MADV_WILLNEED);
+      }
+    }
+
+    /**
+     * Drop the pages that lie completely within n elements from the
+     * memory of the process. The file keeps their changes, so they are
+     * only read again if touched. Anonymous pages would lose their
+     * contents and are left alone.
+     */
+    void release(const T* p, const std::size_t n) const noexcept {
+      const std::uintptr_t first = pageCeil(reinterpret_cast<std::uintptr_t>(p));
+      const std::uintptr_t last = pageFloor(reinterpret_cast<std::uintptr_t>(p + n));
+      if (_path && last > first) {
+        ::madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+      }
+    }
+
+    /// Path of the file, null for anonymous pages
+    inline const std::shared_ptr<std::string>& backing() const noexcept {
+      return _path;
+    }
+
+    /// Whether anonymous huge pages are mapped
+    inline bool hugePages() const noexcept {
+      return _huge;
+    }
+
+    /// Allocators with the same backing can release each other's memory
+    template<class U>
+    bool operator==(const mmap_allocator<U, Align>& other) const noexcept {
+      return _path == other.backing() && _huge == other.hugePages();
+    }
+
+    template<class U>
+    bool operator!=(const mmap_allocator<U, Align>& other) const noexcept {
+      return !(*this == other);
+    }
+
+  private:
+    /// Path of the file, shared by the copies of the allocator
+    std::shared_ptr<std::string> _path;
+
+    /// Anonymous huge pages, the file takes precedence
+    bool _huge = false;
+
+    /// Size of the huge pages, the default one of x86-64
+    static constexpr std::size_t HugePageSize = std::size_t(2) << 20;
+
+    /// Size of the mapping of n elements
+    inline std::size_t mappedBytes(const std::size_t n) const noexcept {
+      const std::size_t bytes = n * sizeof(T);
+      if (_huge && !_path) {
+        return (bytes + HugePageSize - 1) / HugePageSize * HugePageSize;
+      }
+      return pageCeil(bytes);
+    }
+
+    /// Size of the pages
+    static inline std::size_t pageSize() noexcept {
+      static const std::size_t size = std::size_t(::sysconf(_SC_PAGESIZE));
+      return size;
+    }
+
+    static inline std::size_t pageFloor(const std::size_t bytes) noexcept {
+      return bytes / pageSize() * pageSize();
+    }
+
+    static inline std::size_t pageCeil(const std::size_t bytes) noexcept {
+      return (bytes + pageSize() - 1) / pageSize() * pageSize();
+    }
+  };
+
+
   /**
-   * Check if a class is an aligned_allocator or an aligned_row_allocator
+   * Check if a class is an aligned_allocator, an aligned_row_allocator
+   * or an mmap_allocator
    */
   template<class Alloc>
   struct is_aligned_alloc {
@@ -94,6 +292,12 @@ namespace anpi {
     static const bool value = true;
   };
 
+  // Specialization for the mmap_allocator
+  template<typename T, std::size_t A>
+  struct is_aligned_alloc< anpi::mmap_allocator<T,A> > {
+    static const bool value = true;
+  };
+
   /**
    * Create metafunction has_type_row_aligned<T>
    */
@@ -116,7 +320,7 @@ namespace anpi {
   };
 
   /**
-   * Specialization covers both aligned allocators
+   * Specialization covers the aligned allocators
    *
    * We assume that the second integral parameter of the template type
    * corresponds to the alignment parameter.
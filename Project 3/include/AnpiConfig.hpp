@@ -9,4 +9,5 @@
 
 #define ANPI_ENABLE_SIMD
 #define ANPI_ENABLE_OpenMP
+/* #undef ANPI_ENABLE_MPI */
 #define ANPI_DATA_PATH "/home/erick/Desktop/HDD/TEC/ANPI/P3/Project3/data"
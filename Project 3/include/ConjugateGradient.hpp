@@ -0,0 +1,519 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_CONJUGATE_GRADIENT_H
+#define ANPI_CONJUGATE_GRADIENT_H
+
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "Matrix.hpp"
+#include "Exception.hpp"
+#include "Liebmann.hpp"
+#include "ParallelOptions.hpp"
+
+namespace anpi {
+
+    /**
+     * Preconditioner of the conjugate gradient solver
+     */
+    enum class CGPreconditioner {
+        /// Inverse of the diagonal. The diagonal of the plate operator is
+        /// uniform, so it only scales the residual like plain CG does
+        Jacobi,
+        /// Incomplete Cholesky factorization without fill-in, IC(0)
+        IncompleteCholesky
+    };
+
+
+    /**
+     * Parameters of the conjugate gradient solver
+     */
+    struct CGOptions {
+        /// Preconditioner applied to the residual on every iteration
+        CGPreconditioner preconditioner = CGPreconditioner::IncompleteCholesky;
+
+        /// Euclidean norm of the residual relative to the initial one accepted as converged
+        double tolerance = 1e-8;
+
+        /// Maximum number of iterations
+        size_t maxIterations = 100000;
+
+        /// Threads and schedule of the OpenMP regions
+        ParallelOptions parallel;
+
+        /// When not null, receives the relative residual of every iteration
+        std::vector<double> *residualHistory = nullptr;
+    };
+
+
+    namespace cgimpl {
+
+        /**
+         * The plate operator A = I - W, with W the weighted mean of the four
+         * neighbours, is only symmetric when opposite borders share their
+         * isolation, otherwise the isolated side doubles the weight of the
+         * opposite neighbour
+         *
+         * @tparam T        : Data type
+         * @param weights   : Stencil weights given by the isolation of the borders
+         * @return          : True if the operator is symmetric positive definite
+         */
+        template<typename T>
+        inline bool isSymmetric(const StencilWeights<T> &weights) {
+            return (weights.up == weights.down) && (weights.left == weights.right);
+        }
+
+
+        /**
+         * Residual r = W x - x of the inner pixels of the plate, the borders of
+         * x are the frontier conditions so they play the part of the right hand
+         * side
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param plate     : Current state of the plate
+         * @param r         : Matrix where the residual is written, borders are not written
+         * @param w         : Stencil weights of the plate
+         * @param parallel  : Threads and schedule of the OpenMP regions
+         * @return          : Squared euclidean norm of the residual
+         */
+        template<typename T, class Alloc>
+        T residual(const anpi::Matrix<T, Alloc> &plate,
+                   anpi::Matrix<T, Alloc> &r,
+                   const StencilWeights<T> &w,
+                   const ParallelOptions &parallel) {
+
+            const size_t rows = plate.rows();
+            const size_t cols = plate.cols();
+            const int threads = parallel.threadsFor(rows * cols, rows - 2);
+            T squares = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) reduction(+ : squares)
+#endif
+            for (size_t i = 1; i < rows - 1; ++i) {
+
+                const T *row = plate[i];
+                const T *up = plate[i - 1];
+                const T *down = plate[i + 1];
+                T *res = r[i];
+
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    res[j] = w.up * up[j] + w.down * down[j] + w.left * row[j - 1] + w.right * row[j + 1] - row[j];
+                    squares += res[j] * res[j];
+                }
+            }
+
+            return squares;
+        }
+
+
+        /**
+         * Applies the operator q = A p = p - W p on the inner pixels, the
+         * borders of p must be zero
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param p         : Search direction
+         * @param q         : Matrix where the product is written, borders are not written
+         * @param w         : Stencil weights of the plate
+         * @param parallel  : Threads and schedule of the OpenMP regions
+         * @return          : Dot product of p and q
+         */
+        template<typename T, class Alloc>
+        T apply(const anpi::Matrix<T, Alloc> &p,
+                anpi::Matrix<T, Alloc> &q,
+                const StencilWeights<T> &w,
+                const ParallelOptions &parallel) {
+
+            const size_t rows = p.rows();
+            const size_t cols = p.cols();
+            const int threads = parallel.threadsFor(rows * cols, rows - 2);
+            T dot = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) reduction(+ : dot)
+#endif
+            for (size_t i = 1; i < rows - 1; ++i) {
+
+                const T *row = p[i];
+                const T *up = p[i - 1];
+                const T *down = p[i + 1];
+                T *product = q[i];
+
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    product[j] = row[j] - (w.up * up[j] + w.down * down[j] + w.left * row[j - 1] + w.right * row[j + 1]);
+                    dot += row[j] * product[j];
+                }
+            }
+
+            return dot;
+        }
+
+
+        /**
+         * Diagonal of the IC(0) factor of the operator. The factor keeps the
+         * sparsity of the lower part of A, so only its diagonal has to be
+         * computed: d(i, j) = 1 - up^2 / d(i - 1, j) - left^2 / d(i, j - 1)
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param rows      : Rows of the plate, borders included
+         * @param cols      : Columns of the plate, borders included
+         * @param w         : Stencil weights of the plate, symmetric
+         * @return          : Inverse of the diagonal of the factor, zero on the borders
+         */
+        template<typename T, class Alloc>
+        anpi::Matrix<T, Alloc> incompleteCholesky(const size_t rows,
+                                                  const size_t cols,
+                                                  const StencilWeights<T> &w) {
+
+            // The diagonal is kept on the borders so the recurrence needs no branch
+            anpi::Matrix<T, Alloc> diagonal(rows, cols, T(1));
+            const T up2 = w.up * w.up;
+            const T left2 = w.left * w.left;
+
+            for (size_t i = 1; i < rows - 1; ++i) {
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    const T fromUp = (i > 1) ? up2 / diagonal(i - 1, j) : T(0);
+                    const T fromLeft = (j > 1) ? left2 / diagonal(i, j - 1) : T(0);
+                    diagonal(i, j) = T(1) - fromUp - fromLeft;
+                }
+            }
+
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < cols; ++j) {
+                    const bool isBorder = (i == 0) || (j == 0) || (i == rows - 1) || (j == cols - 1);
+                    diagonal(i, j) = isBorder ? T(0) : T(1) / diagonal(i, j);
+                }
+            }
+
+            return diagonal;
+        }
+
+
+        /**
+         * Solves M z = r with M = (D + L) D^-1 (D + L^T) the IC(0)
+         * preconditioner, L being the strictly lower part of A. Both triangular
+         * solves run in the natural order of the pixels.
+         *
+         * @tparam T            : Data type
+         * @tparam Alloc        : Allocator used for row allignment in the matrix values
+         * @param r             : Residual
+         * @param z             : Matrix where the preconditioned residual is written, borders must be zero
+         * @param inverseDiagonal: Inverse of the diagonal of the factor
+         * @param w             : Stencil weights of the plate
+         */
+        template<typename T, class Alloc>
+        void solveIncompleteCholesky(const anpi::Matrix<T, Alloc> &r,
+                                     anpi::Matrix<T, Alloc> &z,
+                                     const anpi::Matrix<T, Alloc> &inverseDiagonal,
+                                     const StencilWeights<T> &w) {
+
+            const size_t rows = r.rows();
+            const size_t cols = r.cols();
+
+            // Forward: (D + L) y = r, the zero borders of z stand for the missing neighbours
+            for (size_t i = 1; i < rows - 1; ++i) {
+                const T *res = r[i];
+                const T *inverse = inverseDiagonal[i];
+                const T *up = z[i - 1];
+                T *row = z[i];
+
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    row[j] = (res[j] + w.up * up[j] + w.left * row[j - 1]) * inverse[j];
+                }
+            }
+
+            // Backward: (I + D^-1 L^T) z = y
+            for (size_t i = rows - 2; i > 0; --i) {
+                const T *inverse = inverseDiagonal[i];
+                const T *down = z[i + 1];
+                T *row = z[i];
+
+                for (size_t j = cols - 2; j > 0; --j) {
+                    row[j] += (w.down * down[j] + w.right * row[j + 1]) * inverse[j];
+                }
+            }
+        }
+
+
+        /**
+         * Applies the preconditioner z = M^-1 r
+         *
+         * @tparam T            : Data type
+         * @tparam Alloc        : Allocator used for row allignment in the matrix values
+         * @param r             : Residual
+         * @param z             : Matrix where the preconditioned residual is written, borders must be zero
+         * @param inverseDiagonal: Inverse of the diagonal of the IC(0) factor, unused by Jacobi
+         * @param w             : Stencil weights of the plate
+         * @param options       : Preconditioner and threads
+         * @return              : Dot product of r and z
+         */
+        template<typename T, class Alloc>
+        T precondition(const anpi::Matrix<T, Alloc> &r,
+                       anpi::Matrix<T, Alloc> &z,
+                       const anpi::Matrix<T, Alloc> &inverseDiagonal,
+                       const StencilWeights<T> &w,
+                       const CGOptions &options) {
+
+            const size_t rows = r.rows();
+            const size_t cols = r.cols();
+            const int threads = options.parallel.threadsFor(rows * cols, rows - 2);
+            T dot = T(0);
+
+            // The diagonal of A is one, so Jacobi copies the residual
+            if (options.preconditioner == CGPreconditioner::Jacobi) {
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) reduction(+ : dot)
+#endif
+                for (size_t i = 1; i < rows - 1; ++i) {
+                    const T *res = r[i];
+                    T *row = z[i];
+
+                    for (size_t j = 1; j < cols - 1; ++j) {
+                        row[j] = res[j];
+                        dot += res[j] * res[j];
+                    }
+                }
+
+                return dot;
+            }
+
+            solveIncompleteCholesky(r, z, inverseDiagonal, w);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) reduction(+ : dot)
+#endif
+            for (size_t i = 1; i < rows - 1; ++i) {
+                const T *res = r[i];
+                const T *row = z[i];
+
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    dot += res[j] * row[j];
+                }
+            }
+
+            return dot;
+        }
+
+
+        /**
+         * Updates x += alpha p and r -= alpha q on the inner pixels
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param x         : Plate
+         * @param r         : Residual
+         * @param p         : Search direction
+         * @param q         : Operator applied to the search direction
+         * @param alpha     : Step length
+         * @param parallel  : Threads and schedule of the OpenMP regions
+         * @return          : Squared euclidean norm of the new residual
+         */
+        template<typename T, class Alloc>
+        T step(anpi::Matrix<T, Alloc> &x,
+               anpi::Matrix<T, Alloc> &r,
+               const anpi::Matrix<T, Alloc> &p,
+               const anpi::Matrix<T, Alloc> &q,
+               const T alpha,
+               const ParallelOptions &parallel) {
+
+            const size_t rows = x.rows();
+            const size_t cols = x.cols();
+            const int threads = parallel.threadsFor(rows * cols, rows - 2);
+            T squares = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) reduction(+ : squares)
+#endif
+            for (size_t i = 1; i < rows - 1; ++i) {
+                T *plate = x[i];
+                T *res = r[i];
+                const T *direction = p[i];
+                const T *product = q[i];
+
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    plate[j] += alpha * direction[j];
+                    res[j] -= alpha * product[j];
+                    squares += res[j] * res[j];
+                }
+            }
+
+            return squares;
+        }
+
+
+        /**
+         * Updates the search direction p = z + beta p on the inner pixels
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param p         : Search direction
+         * @param z         : Preconditioned residual
+         * @param beta      : Weight of the previous direction
+         * @param parallel  : Threads and schedule of the OpenMP regions
+         */
+        template<typename T, class Alloc>
+        void direction(anpi::Matrix<T, Alloc> &p,
+                       const anpi::Matrix<T, Alloc> &z,
+                       const T beta,
+                       const ParallelOptions &parallel) {
+
+            const size_t rows = p.rows();
+            const size_t cols = p.cols();
+            const int threads = parallel.threadsFor(rows * cols, rows - 2);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+            for (size_t i = 1; i < rows - 1; ++i) {
+                T *row = p[i];
+                const T *pre = z[i];
+
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    row[j] = pre[j] + beta * row[j];
+                }
+            }
+        }
+
+    } // namespace cgimpl
+
+
+    /**
+     * Solves the plate with the matrix free preconditioned conjugate gradient
+     * method. The operator applies the same 5-point stencil and isolation
+     * weights as the pixel phase of liebmannAux. It needs O(n) iterations on
+     * an n x n plate where the relaxation needs O(n^2).
+     *
+     * When a border is isolated but not the opposite one the operator is not
+     * symmetric and CG does not apply, in that case the plate is solved with
+     * red-black SOR with the same tolerance on the change of the pixels.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param operationMatrix   : Initial state of the plate with the frontier conditions, overwritten with the result
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param options           : Preconditioner, tolerance and threads
+     * @return                  : Number of iterations made
+     */
+    template<typename T, class Alloc>
+    size_t conjugateGradientAux(anpi::Matrix<T, Alloc> &operationMatrix,
+                                const std::vector<bool> &isIsolated,
+                                const CGOptions &options = CGOptions()) {
+
+        const StencilWeights<T> weights = isolationWeights<T>(isIsolated);
+
+        if (!cgimpl::isSymmetric(weights)) {
+            std::vector<double> history;
+            LiebmannOptions sorOptions;
+            sorOptions.method = LiebmannMethod::RedBlackSOR;
+            sorOptions.tolerance = options.tolerance;
+            sorOptions.maxIterations = options.maxIterations;
+            sorOptions.parallel = options.parallel;
+            sorOptions.residualHistory = &history;
+
+            liebmannAux(operationMatrix, isIsolated, T(1), options.parallel.isUsingOpenMP, sorOptions);
+
+            if (options.residualHistory) {
+                *options.residualHistory = history;
+            }
+            return history.size();
+        }
+
+        const size_t rows = operationMatrix.rows();
+        const size_t cols = operationMatrix.cols();
+
+        // The borders of the work vectors stay zero all along
+        anpi::Matrix<T, Alloc> r(rows, cols, T(0));
+        anpi::Matrix<T, Alloc> z(rows, cols, T(0));
+        anpi::Matrix<T, Alloc> p(rows, cols, T(0));
+        anpi::Matrix<T, Alloc> q(rows, cols, T(0));
+        anpi::Matrix<T, Alloc> inverseDiagonal;
+
+        if (options.preconditioner == CGPreconditioner::IncompleteCholesky) {
+            inverseDiagonal = cgimpl::incompleteCholesky<T, Alloc>(rows, cols, weights);
+        }
+
+        const T initialNorm = std::sqrt(cgimpl::residual(operationMatrix, r, weights, options.parallel));
+
+        if (options.residualHistory) {
+            options.residualHistory->clear();
+        }
+
+        if (initialNorm == T(0)) {
+            return 0;
+        }
+
+        T rz = cgimpl::precondition(r, z, inverseDiagonal, weights, options);
+        cgimpl::direction(p, z, T(0), options.parallel);
+
+        size_t iterations = 0;
+        while (iterations < options.maxIterations) {
+            const T pq = cgimpl::apply(p, q, weights, options.parallel);
+            const T alpha = rz / pq;
+            const T relative = std::sqrt(cgimpl::step(operationMatrix, r, p, q, alpha, options.parallel)) / initialNorm;
+            ++iterations;
+
+            if (options.residualHistory) {
+                options.residualHistory->push_back(double(relative));
+            }
+
+            if (relative <= T(options.tolerance)) {
+                break;
+            }
+
+            const T rzNext = cgimpl::precondition(r, z, inverseDiagonal, weights, options);
+            cgimpl::direction(p, z, rzNext / rz, options.parallel);
+            rz = rzNext;
+        }
+
+        return iterations;
+    }
+
+
+    /**
+     * Master function of the conjugate gradient solver, it has the same frontier
+     * conditions of anpi::liebmann and returns the heat distribution of the plate
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param options           : Conjugate gradient options
+     * @return                  : A matrix with the heat distribution given the border conditions
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> conjugateGradient(anpi::Matrix<T, Alloc> &frontierConditions,
+                                             const size_t verticalLength,
+                                             const size_t horizontalLength,
+                                             const std::vector<bool> &isIsolated,
+                                             const CGOptions &options = CGOptions()) {
+
+        anpi::Matrix<T, Alloc> operationMatrix = initializePlate(frontierConditions,
+                                                                 verticalLength,
+                                                                 horizontalLength,
+                                                                 isIsolated);
+
+        conjugateGradientAux(operationMatrix, isIsolated, options);
+
+        return operationMatrix;
+    }
+
+
+} //namespace anpi
+
+
+#endif //ANPI_CONJUGATE_GRADIENT_H
@@ -0,0 +1,103 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_CONVERGENCE_MONITOR_H
+#define ANPI_CONVERGENCE_MONITOR_H
+
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "bits/Stencil.hpp"
+
+namespace anpi {
+
+    /**
+     * Norm used to measure the change of the plate between iterations
+     */
+    enum class ConvergenceNorm {
+        /// Largest absolute change of a pixel
+        Max,
+        /// Root mean square of the change of the pixels
+        L2
+    };
+
+
+    /**
+     * Decides when an iterative sweep has converged, using the norms that the
+     * sweep kernels accumulate while they compute. The norms are only needed
+     * on the checked iterations, one every checkEvery, so the other sweeps can
+     * skip the measurement.
+     *
+     * @tparam T    :   Data type
+     */
+    template<typename T>
+    class ConvergenceMonitor {
+    public:
+        /**
+         * @param tolerance     :   Largest residual accepted as converged
+         * @param norm          :   Norm used to reduce the change of the pixels
+         * @param checkEvery    :   Number of iterations between checks
+         */
+        ConvergenceMonitor(const T tolerance,
+                           const ConvergenceNorm norm = ConvergenceNorm::Max,
+                           const size_t checkEvery = 1)
+                : _tolerance(tolerance), _norm(norm), _checkEvery(checkEvery > 0 ? checkEvery : 1) {}
+
+        /// True when the norms of the coming iteration will be checked
+        inline bool isCheckIteration() const {
+            return (_iterations + 1) % _checkEvery == 0;
+        }
+
+        /**
+         * Closes an iteration
+         *
+         * @param norms :   Norms of the change of the iteration, ignored when it is not a check iteration
+         * @return      :   True when the iteration was checked and the residual is within the tolerance
+         */
+        bool update(const UpdateNorms<T> &norms) {
+            const bool check = isCheckIteration();
+            ++_iterations;
+
+            if (!check) {
+                return false;
+            }
+
+            _residual = (_norm == ConvergenceNorm::Max)
+                        ? norms.max
+                        : ((norms.count > 0) ? T(std::sqrt(norms.squares / T(norms.count))) : T(0));
+            _history.push_back(_residual);
+
+            return _residual <= _tolerance;
+        }
+
+        /// Iterations closed so far
+        inline size_t iterations() const { return _iterations; }
+
+        /// Residual of the last checked iteration
+        inline T residual() const { return _residual; }
+
+        /// Residuals of all the checked iterations
+        inline const std::vector<T> &history() const { return _history; }
+
+    private:
+        T _tolerance;
+        ConvergenceNorm _norm;
+        size_t _checkEvery;
+        size_t _iterations = 0;
+        T _residual = T(0);
+        std::vector<T> _history;
+    };
+
+
+} //namespace anpi
+
+
+#endif //ANPI_CONVERGENCE_MONITOR_H
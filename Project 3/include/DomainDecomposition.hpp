@@ -0,0 +1,525 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_DOMAIN_DECOMPOSITION_H
+#define ANPI_DOMAIN_DECOMPOSITION_H
+
+
+#include <cstdlib>
+#include <vector>
+#include <deque>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "AnpiConfig.hpp"
+#include "Matrix.hpp"
+#include "Exception.hpp"
+#include "Liebmann.hpp"
+#include "PingPong.hpp"
+#include "ConvergenceMonitor.hpp"
+
+#ifdef ANPI_ENABLE_MPI
+#include <mpi.h>
+#endif
+
+namespace anpi {
+
+    /**
+     * Message passing among the ranks of a decomposed solver. Each rank owns
+     * a part of the plate and only talks to the others through this
+     * interface, so the same solver runs with ranks inside one process or
+     * spread over several nodes.
+     *
+     * @tparam T    :   Data type of the messages
+     */
+    template<typename T>
+    class Communicator {
+    public:
+        /// Rank used to skip one side of an exchange
+        static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+        virtual ~Communicator() = default;
+
+        /// Index of this rank
+        virtual size_t rank() const = 0;
+
+        /// Number of ranks
+        virtual size_t size() const = 0;
+
+        /**
+         * Sends count values to one rank while receiving count values from
+         * another one, any of both can be none
+         *
+         * @param destination   :   Rank receiving the data sent
+         * @param data          :   Values sent
+         * @param source        :   Rank whose data is received
+         * @param received      :   Where the received values are written
+         * @param count         :   Number of values sent and received
+         */
+        virtual void exchange(size_t destination, const T *data,
+                              size_t source, T *received,
+                              size_t count) = 0;
+
+        /// Largest value among all the ranks, every rank must call it
+        virtual T allReduceMax(T value) = 0;
+
+        /// Sum of the values of all the ranks, every rank must call it
+        virtual T allReduceSum(T value) = 0;
+    };
+
+
+    /**
+     * Shared state of ranks running as threads of the same process. The
+     * messages are buffered in a queue per pair of ranks, so a send never
+     * waits for the receiver.
+     *
+     * @tparam T    :   Data type of the messages
+     */
+    template<typename T>
+    class LocalTransport {
+    public:
+        explicit LocalTransport(const size_t ranks)
+                : _ranks(ranks), _mailboxes(ranks * ranks) {}
+
+        /// Number of ranks
+        inline size_t size() const { return _ranks; }
+
+        /// Queues a message from source to destination
+        void post(const size_t source, const size_t destination, std::vector<T> &&message) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _mailboxes[source * _ranks + destination].push_back(std::move(message));
+            }
+            _ready.notify_all();
+        }
+
+        /// Waits for the oldest message from source to destination
+        std::vector<T> take(const size_t source, const size_t destination) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            std::deque<std::vector<T> > &mailbox = _mailboxes[source * _ranks + destination];
+            _ready.wait(lock, [&mailbox] { return !mailbox.empty(); });
+
+            std::vector<T> message = std::move(mailbox.front());
+            mailbox.pop_front();
+            return message;
+        }
+
+        /**
+         * Combines the values of all the ranks, the last rank to arrive
+         * releases the others
+         *
+         * @param value     :   Value of the calling rank
+         * @param isMax     :   True for the largest value, false for the sum
+         * @return          :   Combined value
+         */
+        T reduce(const T value, const bool isMax) {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _partial = (_arrived == 0) ? value : (isMax ? std::max(_partial, value) : _partial + value);
+
+            if (++_arrived == _ranks) {
+                _result = _partial;
+                _arrived = 0;
+                ++_generation;
+                _ready.notify_all();
+            } else {
+                // The result can not be overwritten before this rank reads
+                // it, because the next reduction also needs this rank
+                const size_t generation = _generation;
+                _ready.wait(lock, [this, generation] { return _generation != generation; });
+            }
+
+            return _result;
+        }
+
+    private:
+        size_t _ranks;
+        std::mutex _mutex;
+        std::condition_variable _ready;
+        std::vector<std::deque<std::vector<T> > > _mailboxes;
+        size_t _arrived = 0;
+        size_t _generation = 0;
+        T _partial = T(0);
+        T _result = T(0);
+    };
+
+
+    /**
+     * Communicator of a rank running as a thread, see runLocalRanks
+     *
+     * @tparam T    :   Data type of the messages
+     */
+    template<typename T>
+    class LocalCommunicator : public Communicator<T> {
+    public:
+        LocalCommunicator(LocalTransport<T> &transport, const size_t rank)
+                : _transport(transport), _rank(rank) {}
+
+        size_t rank() const override { return _rank; }
+
+        size_t size() const override { return _transport.size(); }
+
+        void exchange(const size_t destination, const T *data,
+                      const size_t source, T *received,
+                      const size_t count) override {
+
+            if (destination != Communicator<T>::none) {
+                _transport.post(_rank, destination, std::vector<T>(data, data + count));
+            }
+
+            if (source != Communicator<T>::none) {
+                const std::vector<T> message = _transport.take(source, _rank);
+                std::copy(message.begin(), message.begin() + std::min(count, message.size()), received);
+            }
+        }
+
+        T allReduceMax(const T value) override { return _transport.reduce(value, true); }
+
+        T allReduceSum(const T value) override { return _transport.reduce(value, false); }
+
+    private:
+        LocalTransport<T> &_transport;
+        size_t _rank;
+    };
+
+
+#ifdef ANPI_ENABLE_MPI
+
+    namespace bits {
+        inline MPI_Datatype mpiType(double) { return MPI_DOUBLE; }
+
+        inline MPI_Datatype mpiType(float) { return MPI_FLOAT; }
+    } // namespace bits
+
+    /**
+     * Communicator of a rank of an MPI job, MPI must be initialized by the
+     * caller
+     *
+     * @tparam T    :   Data type of the messages, float or double
+     */
+    template<typename T>
+    class MpiCommunicator : public Communicator<T> {
+    public:
+        explicit MpiCommunicator(MPI_Comm comm = MPI_COMM_WORLD) : _comm(comm) {
+            int value;
+            MPI_Comm_rank(_comm, &value);
+            _rank = size_t(value);
+            MPI_Comm_size(_comm, &value);
+            _size = size_t(value);
+        }
+
+        size_t rank() const override { return _rank; }
+
+        size_t size() const override { return _size; }
+
+        void exchange(const size_t destination, const T *data,
+                      const size_t source, T *received,
+                      const size_t count) override {
+
+            const int to = (destination == Communicator<T>::none) ? MPI_PROC_NULL : int(destination);
+            const int from = (source == Communicator<T>::none) ? MPI_PROC_NULL : int(source);
+
+            MPI_Sendrecv(data, int(count), bits::mpiType(T()), to, 0,
+                         received, int(count), bits::mpiType(T()), from, 0,
+                         _comm, MPI_STATUS_IGNORE);
+        }
+
+        T allReduceMax(const T value) override {
+            T result;
+            MPI_Allreduce(&value, &result, 1, bits::mpiType(T()), MPI_MAX, _comm);
+            return result;
+        }
+
+        T allReduceSum(const T value) override {
+            T result;
+            MPI_Allreduce(&value, &result, 1, bits::mpiType(T()), MPI_SUM, _comm);
+            return result;
+        }
+
+    private:
+        MPI_Comm _comm;
+        size_t _rank;
+        size_t _size;
+    };
+
+#endif
+
+
+    /**
+     * Runs a function on several ranks, each one on its own thread of this
+     * process, and waits for all of them. The first exception thrown by a
+     * rank is rethrown once they finish, the function must not throw from
+     * only some of the ranks while the others wait for it.
+     *
+     * @tparam T        :   Data type of the messages
+     * @param ranks     :   Number of ranks
+     * @param function  :   Work of each rank
+     */
+    template<typename T>
+    void runLocalRanks(const size_t ranks, const std::function<void(Communicator<T> &)> &function) {
+        LocalTransport<T> transport(ranks);
+        std::vector<std::exception_ptr> errors(ranks);
+        std::vector<std::thread> threads;
+
+        for (size_t r = 0; r < ranks; ++r) {
+            threads.emplace_back([&transport, &errors, &function, r] {
+                LocalCommunicator<T> comm(transport, r);
+                try {
+                    function(comm);
+                } catch (...) {
+                    errors[r] = std::current_exception();
+                }
+            });
+        }
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        for (const std::exception_ptr &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+
+    /**
+     * Inner rows of the plate owned by a rank, the rows are split in
+     * contiguous strips as even as possible
+     */
+    struct StripDecomposition {
+        /// First inner row of the strip, counting the top border as row 0
+        size_t firstRow;
+
+        /// Number of inner rows of the strip
+        size_t rows;
+
+        /**
+         * @param innerRows :   Inner rows of the plate
+         * @param ranks     :   Number of ranks
+         * @param rank      :   Rank owning the strip
+         */
+        StripDecomposition(const size_t innerRows, const size_t ranks, const size_t rank) {
+            const size_t base = innerRows / ranks;
+            const size_t extra = innerRows % ranks;
+            rows = base + ((rank < extra) ? 1 : 0);
+            firstRow = 1 + rank * base + std::min(rank, extra);
+        }
+    };
+
+
+    /**
+     * Builds the strip of the initial plate owned by a rank, with one halo
+     * row above and below. The strip holds the same values as the rows of
+     * initializePlate, so the whole plate is never built.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param strip             : Rows owned by the rank
+     * @return                  : Matrix of (strip.rows + 2) x (horizontalLength + 2) pixels
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> initializeStrip(anpi::Matrix<T, Alloc> &frontierConditions,
+                                           const size_t verticalLength,
+                                           const size_t horizontalLength,
+                                           const std::vector<bool> &isIsolated,
+                                           const StripDecomposition &strip) {
+
+        const size_t cols = horizontalLength + 2;
+        const size_t rows = strip.rows + 2;
+
+        anpi::Matrix<T, Alloc> operationMatrix(rows, cols, averageFrontier(frontierConditions,
+                                                                           verticalLength,
+                                                                           horizontalLength,
+                                                                           isIsolated));
+
+        for (size_t k = 0; k < rows; ++k) {
+            const size_t row = strip.firstRow - 1 + k;
+
+            if (row == 0 || row == verticalLength + 1) {
+                // Top or bottom border, the corners keep the average
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    operationMatrix(k, j) = frontierConditions((row == 0) ? 0 : 1, j - 1);
+                }
+            } else {
+                operationMatrix(k, 0) = frontierConditions(2, row - 1);
+                operationMatrix(k, cols - 1) = frontierConditions(3, row - 1);
+            }
+        }
+
+        return operationMatrix;
+    }
+
+
+    /**
+     * Sends the first and last inner rows of the strip to the neighbouring
+     * ranks and receives their rows into the halo rows
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param comm              : Communicator of the rank
+     * @param operationMatrix   : Strip with one halo row above and below
+     */
+    template<typename T, class Alloc>
+    void exchangeHalos(Communicator<T> &comm, anpi::Matrix<T, Alloc> &operationMatrix) {
+        const size_t rows = operationMatrix.rows();
+        const size_t cols = operationMatrix.cols();
+        const size_t above = (comm.rank() > 0) ? comm.rank() - 1 : Communicator<T>::none;
+        const size_t below = (comm.rank() + 1 < comm.size()) ? comm.rank() + 1 : Communicator<T>::none;
+
+        // Upwards first, then downwards, so the pairs of sends always match
+        comm.exchange(above, operationMatrix[1], below, operationMatrix[rows - 1], cols);
+        comm.exchange(below, operationMatrix[rows - 2], above, operationMatrix[0], cols);
+    }
+
+
+    /**
+     * Relaxed Jacobi solver for a plate split in horizontal strips among the
+     * ranks of a communicator. Each rank only stores its strip plus one halo
+     * row on each side, which is refreshed from the neighbours before every
+     * sweep. The isolation of the borders is the same for all pixels, so it
+     * is resolved into the stencil weights as in liebmann, and the norms of
+     * the change are reduced among all the ranks on the checked iterations.
+     * The result does not depend on the number of ranks.
+     *
+     * All the ranks must call it with the same arguments.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param comm              : Communicator of the rank
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param lambda            : Relaxation coefficient
+     * @param options           : Tolerance, iteration limit, norm and threads of each rank
+     * @return                  : Strip of the rank with its halo rows, see StripDecomposition
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> decomposedLiebmann(Communicator<T> &comm,
+                                              anpi::Matrix<T, Alloc> &frontierConditions,
+                                              const size_t verticalLength,
+                                              const size_t horizontalLength,
+                                              const std::vector<bool> &isIsolated,
+                                              const T lambda = 1,
+                                              const LiebmannOptions &options = LiebmannOptions()) {
+
+        if (comm.size() > verticalLength) {
+            throw anpi::Exception("Cada proceso necesita al menos una fila de la placa");
+        }
+
+        const StripDecomposition strip(verticalLength, comm.size(), comm.rank());
+        const StencilWeights<T> weights = isolationWeights<T>(isIsolated);
+
+        PingPong<T, Alloc> grids(initializeStrip(frontierConditions,
+                                                 verticalLength,
+                                                 horizontalLength,
+                                                 isIsolated,
+                                                 strip));
+
+        ConvergenceMonitor<T> monitor(T(options.tolerance), options.norm, options.checkEvery);
+
+        for (size_t k = 0; k < options.maxIterations; ++k) {
+            // The halos of the back grid are stale, but they are only read
+            // after the swap once they are exchanged again
+            exchangeHalos(comm, grids.front());
+
+            const bool check = monitor.isCheckIteration();
+            UpdateNorms<T> norms = jacobiSweep(grids.back(), grids.front(), weights, lambda,
+                                               check, options.parallel);
+            grids.swap();
+
+            if (check) {
+                norms.max = comm.allReduceMax(norms.max);
+                norms.squares = comm.allReduceSum(norms.squares);
+                norms.count = verticalLength * horizontalLength;
+            }
+
+            if (monitor.update(norms)) {
+                break;
+            }
+        }
+
+        if (options.residualHistory) {
+            options.residualHistory->assign(monitor.history().begin(), monitor.history().end());
+        }
+
+        return grids.release();
+    }
+
+
+    /**
+     * Assembles the strips of all the ranks into the whole plate on rank 0
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param comm              : Communicator of the rank
+     * @param operationMatrix   : Strip of the rank, as returned by decomposedLiebmann
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @return                  : The plate on rank 0, an empty matrix on the other ranks
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> gatherPlate(Communicator<T> &comm,
+                                       const anpi::Matrix<T, Alloc> &operationMatrix,
+                                       const size_t verticalLength) {
+
+        const size_t cols = operationMatrix.cols();
+
+        if (comm.rank() != 0) {
+            const StripDecomposition strip(verticalLength, comm.size(), comm.rank());
+            // The last rank also sends the bottom border
+            const size_t rows = strip.rows + ((comm.rank() + 1 == comm.size()) ? 1 : 0);
+
+            std::vector<T> data(rows * cols);
+            for (size_t k = 0; k < rows; ++k) {
+                std::copy(operationMatrix[k + 1], operationMatrix[k + 1] + cols, data.begin() + k * cols);
+            }
+            comm.exchange(0, data.data(), Communicator<T>::none, nullptr, data.size());
+
+            return anpi::Matrix<T, Alloc>();
+        }
+
+        anpi::Matrix<T, Alloc> plate(verticalLength + 2, cols, anpi::DoNotInitialize);
+
+        // Own strip with the top border, and the bottom border when alone
+        const StripDecomposition own(verticalLength, comm.size(), 0);
+        const size_t ownRows = own.rows + ((comm.size() == 1) ? 2 : 1);
+        for (size_t k = 0; k < ownRows; ++k) {
+            std::copy(operationMatrix[k], operationMatrix[k] + cols, plate[k]);
+        }
+
+        for (size_t r = 1; r < comm.size(); ++r) {
+            const StripDecomposition strip(verticalLength, comm.size(), r);
+            const size_t rows = strip.rows + ((r + 1 == comm.size()) ? 1 : 0);
+
+            std::vector<T> data(rows * cols);
+            comm.exchange(Communicator<T>::none, nullptr, r, data.data(), data.size());
+            for (size_t k = 0; k < rows; ++k) {
+                std::copy(data.begin() + k * cols, data.begin() + (k + 1) * cols, plate[strip.firstRow + k]);
+            }
+        }
+
+        return plate;
+    }
+
+
+} //namespace anpi
+
+
+#endif //ANPI_DOMAIN_DECOMPOSITION_H
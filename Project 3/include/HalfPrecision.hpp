@@ -0,0 +1,202 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_HALF_PRECISION_HPP
+#define ANPI_HALF_PRECISION_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Intrinsics.hpp"
+
+namespace anpi {
+
+    /**
+     * Storage of a float in 16 bits, the upper half of its representation:
+     * the same range as float with 8 bits of mantissa. Values are converted
+     * to float to operate with them and rounded to the nearest even when
+     * stored back.
+     */
+    struct bfloat16 {
+        /// Upper 16 bits of the float
+        std::uint16_t bits;
+
+        /// Uninitialized, as the built-in types
+        bfloat16() = default;
+
+        /// Rounds a float to the nearest bfloat16
+        bfloat16(const float value) : bits(fromFloat(value)) { }
+
+        /// Value as a float, exact
+        inline operator float() const {
+            const std::uint32_t wide = std::uint32_t(bits) << 16;
+            float value;
+            std::memcpy(&value, &wide, sizeof(value));
+            return value;
+        }
+
+        /// Upper 16 bits of a float, rounded to the nearest even
+        static inline std::uint16_t fromFloat(const float value) {
+            std::uint32_t wide;
+            std::memcpy(&wide, &value, sizeof(wide));
+
+            if ((wide & 0x7FFFFFFFu) > 0x7F800000u) { // NaN stays quiet NaN
+                return std::uint16_t((wide >> 16) | 0x40u);
+            }
+            wide += 0x7FFFu + ((wide >> 16) & 1u);
+            return std::uint16_t(wide >> 16);
+        }
+    };
+
+
+    /**
+     * IEEE 754 half precision storage: 5 bits of exponent and 11 bits of
+     * mantissa, the largest finite value is 65504. Values are converted to
+     * float to operate with them and rounded to the nearest even when stored
+     * back. The conversions use F16C when it is available.
+     */
+    struct half {
+        /// Binary16 representation
+        std::uint16_t bits;
+
+        /// Uninitialized, as the built-in types
+        half() = default;
+
+        /// Rounds a float to the nearest half
+        half(const float value) : bits(fromFloat(value)) { }
+
+        /// Value as a float, exact
+        inline operator float() const {
+#ifdef __F16C__
+            return _cvtsh_ss(bits);
+#else
+            const std::uint32_t sign = std::uint32_t(bits & 0x8000u) << 16;
+            const std::uint32_t exponent = (bits >> 10) & 0x1Fu;
+            const std::uint32_t mantissa = bits & 0x3FFu;
+
+            std::uint32_t wide;
+            if (exponent == 0x1Fu) {            // Infinity or NaN
+                wide = sign | 0x7F800000u | (mantissa << 13);
+            } else if (exponent != 0) {         // Normal, the bias goes from 15 to 127
+                wide = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+            } else {                            // Subnormal or zero: mantissa * 2^-24
+                const float value = float(mantissa) * 5.9604644775390625e-8f;
+                return sign ? -value : value;
+            }
+
+            float value;
+            std::memcpy(&value, &wide, sizeof(value));
+            return value;
+#endif
+        }
+
+        /// Binary16 representation of a float, rounded to the nearest even
+        static inline std::uint16_t fromFloat(const float value) {
+#ifdef __F16C__
+            return _cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT);
+#else
+            std::uint32_t wide;
+            std::memcpy(&wide, &value, sizeof(wide));
+
+            const std::uint32_t sign = (wide >> 16) & 0x8000u;
+            const std::uint32_t magnitude = wide & 0x7FFFFFFFu;
+
+            if (magnitude >= 0x7F800000u) {     // Infinity or NaN
+                return std::uint16_t(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+            }
+            if (magnitude >= 0x477FF000u) {     // Rounds above 65504
+                return std::uint16_t(sign | 0x7C00u);
+            }
+
+            std::uint32_t result, rest, halfway;
+            if (magnitude < 0x38800000u) {      // Below 2^-14 the result is subnormal
+                if (magnitude < 0x33000000u) {
+                    return std::uint16_t(sign);
+                }
+                const std::uint32_t shift = 126u - (magnitude >> 23);
+                const std::uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+                result = mantissa >> shift;
+                rest = mantissa & ((1u << shift) - 1u);
+                halfway = 1u << (shift - 1u);
+            } else {
+                result = (magnitude - 0x38000000u) >> 13;
+                rest = magnitude & 0x1FFFu;
+                halfway = 0x1000u;
+            }
+
+            if (rest > halfway || (rest == halfway && (result & 1u))) {
+                ++result;
+            }
+            return std::uint16_t(sign | result);
+#endif
+        }
+    };
+
+
+    /**
+     * Data type in which the values of a storage type are operated
+     *
+     * @tparam T    :   Storage type
+     */
+    template<typename T>
+    struct compute_type {
+        typedef T type;
+    };
+
+    template<>
+    struct compute_type<bfloat16> {
+        typedef float type;
+    };
+
+    template<>
+    struct compute_type<half> {
+        typedef float type;
+    };
+
+    /// Shorthand for the type in which a storage type is operated
+    template<typename T>
+    using compute_t = typename compute_type<T>::type;
+
+
+    /**
+     * Whether the SIMD load and store helpers handle a storage type. The
+     * conversions of bfloat16 need AVX2 and the ones of half need F16C
+     *
+     * @tparam T    :   Storage type
+     */
+    template<typename T>
+    struct is_simd_storage {
+        static constexpr bool value =
+                std::is_same<T, double>::value ||
+                std::is_same<T, float>::value
+#ifdef __AVX2__
+                || std::is_same<T, bfloat16>::value
+#endif
+#ifdef __F16C__
+                || std::is_same<T, half>::value
+#endif
+                ;
+    };
+
+} // namespace anpi
+
+
+#ifdef __AVX__
+template<> struct avx_traits<anpi::bfloat16> { typedef __m256 reg_type; };
+template<> struct avx_traits<anpi::half> { typedef __m256 reg_type; };
+#endif
+
+#ifdef __AVX512F__
+template<> struct avx512_traits<anpi::bfloat16> { typedef __m512 reg_type; };
+template<> struct avx512_traits<anpi::half> { typedef __m512 reg_type; };
+#endif
+
+
+#endif //ANPI_HALF_PRECISION_HPP
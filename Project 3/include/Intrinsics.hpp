@@ -68,6 +68,12 @@ template<> struct avx_traits<int8_t> { typedef __m256i reg_type; };
 template<> struct avx_traits<uint8_t> { typedef __m256i reg_type; };
 #endif
 
+#ifdef __AVX512F__
+template<typename T> struct avx512_traits { };
+template<> struct avx512_traits<double> { typedef __m512d reg_type; };
+template<> struct avx512_traits<float> { typedef __m512 reg_type; };
+#endif
+
 
 
 #endif
@@ -16,18 +16,372 @@
 #include <cstdlib>
 #include <functional>
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <vector>
 
 #include "Matrix.hpp"
 #include "Exception.hpp"
+#include "bits/Stencil.hpp"
+#include "ConvergenceMonitor.hpp"
+#include "PingPong.hpp"
+#include "ParallelOptions.hpp"
 
 namespace anpi {
 
+    /**
+     * Method used on the pixel by pixel phase of liebmannAux, once the
+     * chunk warmup is finished
+     */
+    enum class LiebmannMethod {
+        /// Relaxed Jacobi sweep over a copy of the last iteration
+        Jacobi,
+        /// In-place red-black ordered SOR with the optimal omega of the grid
+        RedBlackSOR
+    };
+
+
+    /**
+     * Extra parameters used to control the pixel by pixel phase
+     */
+    struct LiebmannOptions {
+        /// Method used after the chunk warmup
+        LiebmannMethod method = LiebmannMethod::Jacobi;
+
+        /// Largest residual accepted as converged, measured with norm (RedBlackSOR and warm starts)
+        double tolerance = 1e-4;
+
+        /// Maximum number of sweeps allowed on the pixel phase, a tiled Jacobi sweep counts once
+        size_t maxIterations = 100000;
+
+        /// Jacobi iterations advanced on a tile while it is in cache (Jacobi), 1 sweeps the whole plate each time
+        size_t tileIterations = 1;
+
+        /// Inner rows and columns of each tile (Jacobi), 0 picks them to fit the tile in the L2 cache
+        size_t tileSize = 0;
+
+        /// Norm of the change between iterations compared against the tolerance
+        ConvergenceNorm norm = ConvergenceNorm::Max;
+
+        /// Iterations between convergence checks, the other sweeps skip the measurement
+        size_t checkEvery = 1;
+
+        /// If not null, receives the residual of every checked iteration
+        std::vector<double> *residualHistory = nullptr;
+
+        /// Threads and schedule of the OpenMP regions
+        ParallelOptions parallel;
+    };
+
+
+    /**
+     * Translates the isolation vector into the stencil weights used on the
+     * pixel by pixel phase. An isolated border makes the pixel reuse the
+     * opposite neighbour, which is equivalent to doubling its weight.
+     *
+     * @tparam T            :   Data type
+     * @param isIsolated    :   Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @return              :   Weights of the neighbours {up; down; left; right}
+     */
+    template<typename T>
+    StencilWeights<T> isolationWeights(const std::vector<bool> &isIsolated) {
+
+        const bool top = isIsolated.at(0);
+        const bool bot = isIsolated.at(1);
+        const bool left = isIsolated.at(2);
+        const bool right = isIsolated.at(3);
+
+        return StencilWeights<T>{T(int(!top) + int(bot)) / 4,
+                                 T(int(top) + int(!bot)) / 4,
+                                 T(int(!left) + int(right)) / 4,
+                                 T(int(left) + int(!right)) / 4};
+    }
+
+
+    /**
+     * Estimates the optimal SOR relaxation factor for the plate, using the
+     * spectral radius of the Jacobi iteration on a rectangular grid.
+     * A direction with just one of its borders isolated only propagates
+     * values one way, so it does not contribute to the spectral radius.
+     *
+     * @tparam T            :   Data type
+     * @param rows          :   Number of rows of the plate, borders included
+     * @param cols          :   Number of columns of the plate, borders included
+     * @param isIsolated    :   Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @return              :   Relaxation factor in [1, 2)
+     */
+    template<typename T>
+    T optimalOmega(const size_t rows,
+                   const size_t cols,
+                   const std::vector<bool> &isIsolated) {
+
+        const T vertical = (isIsolated.at(0) == isIsolated.at(1)) ? T(cos(M_PI / T(rows - 1))) : T(0);
+        const T horizontal = (isIsolated.at(2) == isIsolated.at(3)) ? T(cos(M_PI / T(cols - 1))) : T(0);
+
+        const T rho = (vertical + horizontal) / 2;
+
+        return T(2) / (T(1) + sqrt(T(1) - rho * rho));
+    }
+
+
+    /**
+     * Makes an in-place red-black ordered SOR sweep over the inner pixels of
+     * the plate. All pixels of one color only depend on pixels of the other
+     * color, so each half sweep can be split in rows among the threads.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param operationMatrix   : Matrix updated in place, borders are only read
+     * @param weights           : Stencil weights given by the isolation of the borders
+     * @param omega             : Relaxation factor
+     * @param parallel          : Threads and schedule of the OpenMP regions
+     * @return                  : Norms of the change of the pixels on the sweep
+     */
+    template<typename T, class Alloc>
+    UpdateNorms<T> redBlackSweep(anpi::Matrix<T, Alloc> &operationMatrix,
+                                 const StencilWeights<T> &weights,
+                                 const T omega,
+                                 const ParallelOptions &parallel = ParallelOptions()) {
+
+        const size_t rows = operationMatrix.rows();
+        const size_t cols = operationMatrix.cols();
+        const int threads = parallel.threadsFor(rows * cols, rows - 2);
+        T maxUpdate = T(0);
+        T squares = T(0);
+
+        // The isolation pattern is resolved once, so the sweep is compiled
+        // for the neighbours it actually reads
+        dispatchIsolation(isolationPattern(weights), [&](auto pattern) {
+            constexpr unsigned Pattern = decltype(pattern)::value;
+
+            for (size_t color = 0; color < 2; ++color) {
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) \
+        reduction(max : maxUpdate) reduction(+ : squares)
+#endif
+                for (size_t i = 1; i < rows - 1; ++i) {
+                    const UpdateNorms<T> rowNorms =
+                            ::anpi::aimpl::redBlackRow<Pattern>(operationMatrix, i, color, weights, omega);
+                    maxUpdate = std::max(maxUpdate, rowNorms.max);
+                    squares += rowNorms.squares;
+                }
+            }
+        });
+
+        UpdateNorms<T> norms;
+        norms.max = maxUpdate;
+        norms.squares = squares;
+        norms.count = (rows - 2) * (cols - 2);
+
+        return norms;
+    }
+
+
+    /**
+     * Makes one relaxed Jacobi sweep over the inner pixels of the plate. Each
+     * row only reads the last iteration, so the rows are split among the
+     * threads and the norms of each thread are merged with a reduction.
+     *
+     * The pixels are operated in compute_t<T>, so a plate stored in
+     * bfloat16 or half is swept in float.
+     *
+     * @tparam T                : Data type of the pixels
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param operationMatrix   : Matrix where the new iteration is written, borders are not written
+     * @param lastIteration     : Last iteration of the plate
+     * @param weights           : Stencil weights given by the isolation of the borders
+     * @param lambda            : Relaxation coefficient
+     * @param measure           : Whether to measure the norms of the change, they are empty otherwise
+     * @param parallel          : Threads and schedule of the OpenMP regions
+     * @return                  : Norms of the change of the pixels on the sweep
+     */
+    template<typename T, class Alloc>
+    UpdateNorms<compute_t<T> > jacobiSweep(anpi::Matrix<T, Alloc> &operationMatrix,
+                                           const anpi::Matrix<T, Alloc> &lastIteration,
+                                           const StencilWeights<compute_t<T> > &weights,
+                                           const compute_t<T> lambda,
+                                           const bool measure,
+                                           const ParallelOptions &parallel = ParallelOptions()) {
+
+        typedef compute_t<T> C;
+
+        const size_t rows = lastIteration.rows();
+        const size_t cols = lastIteration.cols();
+        const int threads = parallel.threadsFor(rows * cols, rows - 2);
+        UpdateNorms<C> norms;
+        C maxChange = C(0);
+        C squares = C(0);
+
+        // The isolation pattern is resolved once, so the row kernel is
+        // compiled for the neighbours it actually reads
+        dispatchIsolation(isolationPattern(weights), [&](auto pattern) {
+            constexpr unsigned Pattern = decltype(pattern)::value;
+
+            if (!measure) {
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+                for (size_t i = 1; i < rows - 1; ++i) {
+                    ::anpi::aimpl::stencilRow<Pattern>(operationMatrix, lastIteration, i, weights, lambda);
+                }
+                return;
+            }
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) \
+        reduction(max : maxChange) reduction(+ : squares)
+#endif
+            for (size_t i = 1; i < rows - 1; ++i) {
+                const UpdateNorms<C> rowNorms = ::anpi::aimpl::stencilRowNorms<Pattern>(operationMatrix, lastIteration,
+                                                                                        i, weights, lambda);
+                maxChange = std::max(maxChange, rowNorms.max);
+                squares += rowNorms.squares;
+            }
+        });
+
+        if (!measure) {
+            return norms;
+        }
+
+        norms.max = maxChange;
+        norms.squares = squares;
+        norms.count = (rows - 2) * (cols - 2);
+
+        return norms;
+    }
+
+
+    /**
+     * Advances several relaxed Jacobi iterations with temporal blocking. The
+     * plate is split in tiles, and each tile is copied together with a halo
+     * of one pixel per iteration into two small buffers that stay in cache
+     * while all the iterations are made. The halo is updated redundantly by
+     * the neighbouring tiles, so the tiles are independent and the result is
+     * the same as sweeping the whole plate once per iteration.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param operationMatrix   : Matrix where the result after all the iterations is written
+     * @param lastIteration     : Starting state of the plate
+     * @param weights           : Stencil weights given by the isolation of the borders
+     * @param lambda            : Relaxation coefficient
+     * @param iterations        : Number of Jacobi iterations advanced per tile
+     * @param tileSize          : Inner rows and columns of each tile, 0 to fit the tile buffers in 512 KiB
+     * @param parallel          : Threads and schedule of the OpenMP regions
+     * @return                  : Norms of the change of the pixels over all the iterations
+     */
+    template<typename T, class Alloc>
+    UpdateNorms<T> temporalBlockedJacobi(anpi::Matrix<T, Alloc> &operationMatrix,
+                                         const anpi::Matrix<T, Alloc> &lastIteration,
+                                         const StencilWeights<T> &weights,
+                                         const T lambda,
+                                         const size_t iterations,
+                                         size_t tileSize = 0,
+                                         const ParallelOptions &parallel = ParallelOptions()) {
+
+        const size_t rows = lastIteration.rows();
+        const size_t cols = lastIteration.cols();
+
+        if (tileSize == 0) {
+            // Two square buffers of the tile and its halo in 512 KiB, but
+            // never less inner pixels than halo pixels on each side
+            const size_t side = size_t(sqrt(double(size_t(1) << 19) / double(2 * sizeof(T))));
+            tileSize = std::max(side - std::min(side, 2 * iterations), 2 * iterations);
+        }
+
+        const size_t rowTiles = (rows - 2 + tileSize - 1) / tileSize;
+        const size_t colTiles = (cols - 2 + tileSize - 1) / tileSize;
+        const int threads = parallel.threadsFor(rows * cols, rowTiles * colTiles);
+        const unsigned pattern = isolationPattern(weights);
+        T maxChange = T(0);
+        T squares = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel num_threads(threads) if (threads > 1)
+#endif
+        {
+            // Each thread reuses its own pair of buffers for all its tiles
+            anpi::Matrix<T, Alloc> current, next;
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp for schedule(runtime) reduction(max : maxChange) reduction(+ : squares)
+#endif
+            for (size_t tile = 0; tile < rowTiles * colTiles; ++tile) {
+
+                // Inner pixels written back
+                const size_t iFirst = 1 + (tile / colTiles) * tileSize;
+                const size_t iLast = std::min(iFirst + tileSize, rows - 1);
+                const size_t jFirst = 1 + (tile % colTiles) * tileSize;
+                const size_t jLast = std::min(jFirst + tileSize, cols - 1);
+
+                // Pixels loaded with the halo
+                const size_t iLoadFirst = (iFirst > iterations) ? iFirst - iterations : 0;
+                const size_t iLoadLast = std::min(iLast + iterations, rows);
+                const size_t jLoadFirst = (jFirst > iterations) ? jFirst - iterations : 0;
+                const size_t jLoadLast = std::min(jLast + iterations, cols);
+
+                current.allocate(iLoadLast - iLoadFirst, jLoadLast - jLoadFirst);
+                for (size_t i = iLoadFirst; i < iLoadLast; ++i) {
+                    std::memcpy(current[i - iLoadFirst], lastIteration[i] + jLoadFirst, sizeof(T) * current.cols());
+                }
+                next = current;
+
+                for (size_t k = 1; k <= iterations; ++k) {
+
+                    // The valid rows shrink by one on each side per iteration,
+                    // except on the sides touching the borders of the plate.
+                    // The kernel keeps the first and last columns of the buffer,
+                    // which shrinks the valid columns the same way
+                    const size_t from = (iLoadFirst == 0) ? 1 : k;
+                    const size_t to = (iLoadLast == rows) ? current.rows() - 1 : current.rows() - k;
+
+                    // Dispatched once per iteration of the tile, outside the rows
+                    dispatchIsolation(pattern, [&](auto constant) {
+                        for (size_t i = from; i < to; ++i) {
+                            ::anpi::aimpl::stencilRow<decltype(constant)::value>(next, current, i, weights, lambda);
+                        }
+                    });
+
+                    current.swap(next);
+                }
+
+                // The change is measured while the tile is written back
+                for (size_t i = iFirst; i < iLast; ++i) {
+                    const T *result = current[i - iLoadFirst] + (jFirst - jLoadFirst);
+                    const T *start = lastIteration[i] + jFirst;
+                    T *here = operationMatrix[i] + jFirst;
+
+                    for (size_t j = 0; j < jLast - jFirst; ++j) {
+                        const T change = result[j] - start[j];
+                        maxChange = std::max(maxChange, T(std::abs(change)));
+                        squares += change * change;
+                        here[j] = result[j];
+                    }
+                }
+            }
+        }
+
+        UpdateNorms<T> norms;
+        norms.max = maxChange;
+        norms.squares = squares;
+        norms.count = (rows - 2) * (cols - 2);
+
+        return norms;
+    }
+
+
     /**
      *  Used to get the average value in a chunk on the border pixels, this
      *  chunk is alligned with the size of the pixel block used on the iteration
      *  and changes are saved on the lastIteration matrix since this matrix
      *  is the one used to calculate the new values in the next iteration.
      *
+     *  The top and bottom borders are split in columnSizes chunks and the left
+     *  and right borders in rowSizes chunks, the last chunk of each side
+     *  reaches the corner. Each chunk only touches its own range of a border,
+     *  so both sides are fixed independently.
      *
      * @tparam T            :   Data type
      * @tparam Alloc        :   Allocator used for row allignment in the matrix values
@@ -35,24 +389,22 @@ namespace anpi {
      * @param isIsolated    :   Vector describing if a border is isolated. Convention used: {top; bot; left; right}
      * @param rowIndexes    :   Array of positions in which the matrix rows are grouped
      * @param columnIndexes :   Array of positions in which the matrix columns are grouped
-     * @param sizes         :   Size of the arrays.
+     * @param rowSizes      :   Number of chunks of the left and right borders
+     * @param columnSizes   :   Number of chunks of the top and bottom borders
      */
     template<typename T, class Alloc>
     void fixFrontierConditions(anpi::Matrix<T, Alloc> &lastIteration,
-                               const std::vector<bool> isIsolated,
-                               T *rowIndexes,
-                               T *columnIndexes,
-                               size_t sizes) {
+                               const std::vector<bool> &isIsolated,
+                               const T *rowIndexes,
+                               const T *columnIndexes,
+                               const size_t rowSizes,
+                               const size_t columnSizes) {
 
         // We set the indexes to get the mean of the frontier conditions
-        size_t iStart = 1;
-        size_t iEnd = *rowIndexes++;
         size_t jStart = 1;
-        size_t jEnd = *columnIndexes++;
-
-
-        for (size_t i = 0; i < sizes; ++i) {
+        size_t jEnd = size_t(*columnIndexes++);
 
+        for (size_t k = 0; k < columnSizes; ++k) {
 
             // Fix chunk of rows
             lastIteration.fillRow(lastIteration.averageRow(2 * isIsolated.at(0),
@@ -70,6 +422,20 @@ namespace anpi {
                                   jStart,                       // Determine the range
                                   jEnd);
 
+            // Here we we get boundaries for the next chunk ready
+            jStart = jEnd;
+            if (k + 2 == columnSizes) {
+                jEnd = lastIteration.cols() - 1;
+            } else if (k + 1 < columnSizes) {
+                jEnd = size_t(*columnIndexes++);
+            }
+        }
+
+
+        size_t iStart = 1;
+        size_t iEnd = size_t(*rowIndexes++);
+
+        for (size_t k = 0; k < rowSizes; ++k) {
 
             // Fix chunk of columns
             lastIteration.fillColumn(lastIteration.averageColumn(2 * isIsolated.at(2),
@@ -86,23 +452,40 @@ namespace anpi {
                                      iStart,                       // Determine the range
                                      iEnd);
 
-
-            // Here we we get boundaries for the next iteration ready
-            jStart = jEnd;
+            // Here we we get boundaries for the next chunk ready
             iStart = iEnd;
-            if (i + 2 == sizes) {
-                jEnd = lastIteration.cols() - 1;
+            if (k + 2 == rowSizes) {
                 iEnd = lastIteration.rows() - 1;
-            } else {
-                jEnd = *columnIndexes++;
-                iEnd = *rowIndexes++;
+            } else if (k + 1 < rowSizes) {
+                iEnd = size_t(*rowIndexes++);
             }
-
         }
 
     }
 
 
+    /**
+     * Same as the above, with the same number of chunks on every border
+     *
+     * @tparam T            :   Data type
+     * @tparam Alloc        :   Allocator used for row allignment in the matrix values
+     * @param lastIteration :   Result of the operations on the previous iteration on the matrix
+     * @param isIsolated    :   Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param rowIndexes    :   Array of positions in which the matrix rows are grouped
+     * @param columnIndexes :   Array of positions in which the matrix columns are grouped
+     * @param sizes         :   Size of the arrays.
+     */
+    template<typename T, class Alloc>
+    void fixFrontierConditions(anpi::Matrix<T, Alloc> &lastIteration,
+                               const std::vector<bool> &isIsolated,
+                               const T *rowIndexes,
+                               const T *columnIndexes,
+                               const size_t sizes) {
+
+        fixFrontierConditions(lastIteration, isIsolated, rowIndexes, columnIndexes, sizes, sizes);
+    }
+
+
     /**
      *  Makes the calculation for the new value of a chunk of pixels
      *
@@ -145,24 +528,24 @@ namespace anpi {
 
 
     /**
-     * Gets the indexes to divide the matrix rows by half on each iteration,first row is first
-     * iteration and so on, the las iteration is the maximum row division possible before dividing
-     * the matrix rows in groups of one
+     * Gets the indexes to divide a side of the matrix by half on each iteration, first row is first
+     * iteration and so on, the las iteration is the maximum division possible before dividing
+     * the side in groups of one
      *
      * @tparam T                : Data type
      * @tparam Alloc            : Allocator used for row allignment in the matrix values
-     * @param operationMatrix   : Matrix we will be dividing
+     * @param length            : Pixels of the side we will be dividing, borders included
      * @return                  : Matrix containing the indexes we need to divide in each iteration
      */
     template<typename T, class Alloc>
-    anpi::Matrix<T, Alloc> getRowIndexMatrix(const anpi::Matrix<T, Alloc> &operationMatrix) {
+    anpi::Matrix<T, Alloc> getIndexMatrix(const size_t length) {
         // This is used to determine how many rows and columns the index matrix needs
-        size_t n = ceil(log2(operationMatrix.rows())) - 1;
+        size_t n = ceil(log2(length)) - 1;
         anpi::Matrix<T, Alloc> rowIndex = anpi::Matrix<T, Alloc>(n, pow(2, n) + 1, T(1));
 
         // The first row is set
-        rowIndex(0, 1) = operationMatrix.rows() / 2;
-        rowIndex(0, 2) = operationMatrix.rows() - 1;
+        rowIndex(0, 1) = length / 2;
+        rowIndex(0, 2) = length - 1;
 
         // we now calc the index cuts needed to divide the rows in each iteration
         // the index starts at 1 because we need the initial conditions set befores in order
@@ -190,19 +573,237 @@ namespace anpi {
                 }
 
                 // Completes the other half of the matrix
-                rowIndex(i, pow(2, i + 1) - j) = operationMatrix.rows() - rowIndex(i, j);
+                rowIndex(i, pow(2, i + 1) - j) = length - rowIndex(i, j);
                 //std::cout << "RI: " << previousRowIndex << "   j: " << j << "   i: " << i << std::endl;
             }
 
             // We always start from the position 1 and en in the pos rows - 1
             // to avoid operating the border conditions
-            rowIndex(i, pow(2, i + 1)) = operationMatrix.rows() - 1;
+            rowIndex(i, pow(2, i + 1)) = length - 1;
         }
 
         return rowIndex;
     }
 
 
+    /**
+     * Gets the indexes to divide the matrix rows by half on each iteration,first row is first
+     * iteration and so on, the las iteration is the maximum row division possible before dividing
+     * the matrix rows in groups of one
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param operationMatrix   : Matrix we will be dividing
+     * @return                  : Matrix containing the indexes we need to divide in each iteration
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> getRowIndexMatrix(const anpi::Matrix<T, Alloc> &operationMatrix) {
+        return getIndexMatrix<T, Alloc>(operationMatrix.rows());
+    }
+
+
+    /**
+     * Copies the border lines of a plate, corners included
+     *
+     * @tparam T            :   Data type
+     * @tparam Alloc        :   Allocator used for row allignment in the matrix values
+     * @param plate         :   Plate with its frontier conditions
+     * @return              :   Matrix with the border lines. Convention used: {top; bot; left; right}
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> copyBorders(const anpi::Matrix<T, Alloc> &plate) {
+
+        anpi::Matrix<T, Alloc> borders;
+        copyBorders(plate, borders);
+
+        return borders;
+    }
+
+    /**
+     * Copies the border lines of a plate into a given matrix, which is only
+     * reallocated if its size differs
+     *
+     * @tparam T            :   Data type
+     * @tparam Alloc        :   Allocator used for row allignment in the matrix values
+     * @param plate         :   Plate with its frontier conditions
+     * @param borders       :   Matrix with the border lines. Convention used: {top; bot; left; right}
+     */
+    template<typename T, class Alloc>
+    void copyBorders(const anpi::Matrix<T, Alloc> &plate,
+                     anpi::Matrix<T, Alloc> &borders) {
+
+        const size_t rows = plate.rows();
+        const size_t cols = plate.cols();
+        borders.allocate(4, std::max(rows, cols));
+        borders.fill(T(0));
+
+        std::memcpy(borders[0], plate[0], sizeof(T) * cols);
+        std::memcpy(borders[1], plate[rows - 1], sizeof(T) * cols);
+
+        for (size_t i = 0; i < rows; ++i) {
+            borders(2, i) = plate(i, 0);
+            borders(3, i) = plate(i, cols - 1);
+        }
+    }
+
+
+    /**
+     * Writes back the border lines saved with copyBorders
+     *
+     * @tparam T            :   Data type
+     * @tparam Alloc        :   Allocator used for row allignment in the matrix values
+     * @param plate         :   Plate whose borders are overwritten
+     * @param borders       :   Border lines. Convention used: {top; bot; left; right}
+     */
+    template<typename T, class Alloc>
+    void restoreBorders(anpi::Matrix<T, Alloc> &plate,
+                        const anpi::Matrix<T, Alloc> &borders) {
+
+        const size_t rows = plate.rows();
+        const size_t cols = plate.cols();
+
+        std::memcpy(plate[0], borders[0], sizeof(T) * cols);
+        std::memcpy(plate[rows - 1], borders[1], sizeof(T) * cols);
+
+        for (size_t i = 0; i < rows; ++i) {
+            plate(i, 0) = borders(2, i);
+            plate(i, cols - 1) = borders(3, i);
+        }
+    }
+
+
+    /**
+     * Red-black SOR sweeps in place until the change of the pixels is within
+     * the tolerance
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param operationMatrix   : Plate updated in place, borders are only read
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param tolerance         : Largest residual accepted as converged
+     * @param options           : Norm, checks, iteration limit and residual history
+     * @param parallel          : Threads and schedule of the OpenMP regions
+     * @return                  : Number of sweeps made
+     */
+    template<typename T, class Alloc>
+    size_t sorRelaxation(anpi::Matrix<T, Alloc> &operationMatrix,
+                         const std::vector<bool> &isIsolated,
+                         const T tolerance,
+                         const LiebmannOptions &options,
+                         const ParallelOptions &parallel) {
+
+        const StencilWeights<T> weights = isolationWeights<T>(isIsolated);
+        const T omega = optimalOmega<T>(operationMatrix.rows(), operationMatrix.cols(), isIsolated);
+        ConvergenceMonitor<T> monitor(tolerance, options.norm, options.checkEvery);
+
+        for (size_t k = 0; k < options.maxIterations; ++k) {
+            if (monitor.update(redBlackSweep(operationMatrix, weights, omega, parallel))) {
+                break;
+            }
+        }
+
+        if (options.residualHistory) {
+            options.residualHistory->assign(monitor.history().begin(), monitor.history().end());
+        }
+
+        return monitor.iterations();
+    }
+
+
+    /**
+     * Jacobi sweeps between two grids until the change of the pixels is
+     * within the tolerance, or until options.maxIterations sweeps are made.
+     * The sweeps measure their own change, so no other pass over the matrix
+     * is needed. With temporal blocking the change is measured between
+     * states tileIterations apart.
+     *
+     * @tparam T            : Data type
+     * @tparam Alloc        : Allocator used for row allignment in the matrix values
+     * @param grids         : Plate on the front grid, the back grid must hold the same borders
+     * @param weights       : Stencil weights given by the isolation of the borders
+     * @param lambda        : Relaxation coefficient
+     * @param tolerance     : Largest residual accepted as converged
+     * @param options       : Tiling, norm, checks, iteration limit and residual history
+     * @param parallel      : Threads and schedule of the OpenMP regions
+     * @return              : Number of sweeps made, a tiled sweep counts once
+     */
+    template<typename T, class Alloc>
+    size_t jacobiRelaxation(PingPong<T, Alloc> &grids,
+                            const StencilWeights<T> &weights,
+                            const T lambda,
+                            const T tolerance,
+                            const LiebmannOptions &options,
+                            const ParallelOptions &parallel) {
+
+        ConvergenceMonitor<T> monitor(tolerance, options.norm, options.checkEvery);
+        bool converged = false;
+
+        for (size_t k = 0; !converged && k < options.maxIterations; ++k) {
+            anpi::Matrix<T, Alloc> &target = grids.back();
+            const anpi::Matrix<T, Alloc> &source = grids.front();
+            UpdateNorms<T> norms;
+
+            if (options.tileIterations > 1) {
+                norms = temporalBlockedJacobi(target, source, weights, lambda,
+                                              options.tileIterations, options.tileSize, parallel);
+            } else {
+                norms = jacobiSweep(target, source, weights, lambda, monitor.isCheckIteration(), parallel);
+            }
+
+            grids.swap();
+            converged = monitor.update(norms);
+        }
+
+        if (options.residualHistory) {
+            options.residualHistory->assign(monitor.history().begin(), monitor.history().end());
+        }
+
+        return monitor.iterations();
+    }
+
+
+    /**
+     * Buffers of liebmannAux besides the plate: the back grid, the chunk
+     * indexes and the saved borders. A workspace kept between calls on
+     * plates of the same size is not reallocated, e.g. one per thread on a
+     * batch of plates.
+     *
+     * @tparam T        :   Data type
+     * @tparam Alloc    :   Allocator used for row allignment in the matrix values
+     */
+    template<typename T, class Alloc = anpi::aligned_row_allocator<T> >
+    struct LiebmannWorkspace {
+        /// Memory of the back grid of the relaxation
+        anpi::Matrix<T, Alloc> back;
+
+        /// Chunk indexes of the rows
+        anpi::Matrix<T, Alloc> rowIndex;
+
+        /// Chunk indexes of the columns
+        anpi::Matrix<T, Alloc> columnIndex;
+
+        /// Border lines of the plate. Convention used: {top; bot; left; right}
+        anpi::Matrix<T, Alloc> borders;
+
+        /// Computes the chunk indexes of a plate, unless they are already there
+        void index(const size_t rows, const size_t cols) {
+            if (rows != _indexedRows) {
+                rowIndex = getIndexMatrix<T, Alloc>(rows);
+                _indexedRows = rows;
+            }
+            if (cols != _indexedCols) {
+                columnIndex = getIndexMatrix<T, Alloc>(cols);
+                _indexedCols = cols;
+            }
+        }
+
+    private:
+        /// Lengths the indexes were computed for
+        size_t _indexedRows = 0;
+        size_t _indexedCols = 0;
+    };
+
+
     /**
      * Auxiliary function to Liebmann(*), it operates on chunks of data until maximum division is achived,
      * then it starts to iterate each pixel individually and finished when the substraction of last iteration
@@ -214,46 +815,54 @@ namespace anpi {
      * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
      * @param lambda            : Relaxation coefficient
      * @param isUsingOpenMP     : Flag to activate openMP
+     * @param options           : Method and convergence parameters of the pixel by pixel phase
+     * @param workspace         : Buffers reused between calls
      */
     template<typename T, class Alloc>
     void liebmannAux(anpi::Matrix<T, Alloc> &operationMatrix,
-                     const std::vector<bool> isIsolated,
+                     const std::vector<bool> &isIsolated,
                      const T lambda,
-                     const bool isUsingOpenMP = true) {
+                     const bool isUsingOpenMP,
+                     const LiebmannOptions &options,
+                     LiebmannWorkspace<T, Alloc> &workspace) {
 
         // We create the auxiliary variables
-        anpi::Matrix<T, Alloc> lastIteration, rowIndex, columnIndex;
         T factor = 0;
         size_t limit;
-        bool isTransposed = false;
 
-        // Lets check which dimension is the smallest
-        // we always assume that rows < cols, in case this is not
-        // true, we transpose the matrix and work normally
-        // a flag is set to transpose the matrix again in the end
-        if (operationMatrix.rows() > operationMatrix.cols()) {
-            operationMatrix = operationMatrix.copyTransposed();
-            isTransposed = true;
-        }
-
-
-        // Create the last iteration copy to read from it and
-        // gets the index necessary to reduce the rows and the columns to
-        // individual pixels
-        lastIteration = operationMatrix;
-        rowIndex = getRowIndexMatrix(operationMatrix);
-        columnIndex = getRowIndexMatrix(operationMatrix.copyTransposed());
+        // Gets the index necessary to reduce the rows and the columns to
+        // individual pixels. Both sides are divided together until the
+        // shortest one is done, then only the longest one keeps being divided,
+        // so the plate is worked on in its own orientation
+        workspace.index(operationMatrix.rows(), operationMatrix.cols());
+        const anpi::Matrix<T, Alloc> &rowIndex = workspace.rowIndex;
+        const anpi::Matrix<T, Alloc> &columnIndex = workspace.columnIndex;
+        const size_t sharedLevels = std::min(rowIndex.rows(), columnIndex.rows());
+        const bool isWide = rowIndex.rows() <= columnIndex.rows();
+
+        // The plate and its last iteration live in two grids that are swapped
+        // after each level: the front is read and the back is written. Only
+        // the borders, which fixFrontierConditions changes on the read grid,
+        // have to be restored after each swap
+        PingPong<T, Alloc> grids(std::move(operationMatrix), std::move(workspace.back));
+        copyBorders(grids.front(), workspace.borders);
+        const anpi::Matrix<T, Alloc> &borders = workspace.borders;
+
+        ParallelOptions parallel = options.parallel;
+        parallel.isUsingOpenMP = parallel.isUsingOpenMP && isUsingOpenMP;
+        const size_t pixels = grids.front().rows() * grids.front().cols();
+        int threads;
 
 
         // We iterate over the rows of rowIndex, they contain the indexes
         // to separate the matrix in row chunks, at the same time we also
         // iterate over columnIndex who hat the same function but for the
-        // columns
-        for (size_t i = 0; i < rowIndex.rows(); ++i) {
+        // columns. Each level has limit chunks per side
+        for (size_t i = 0; i < sharedLevels; ++i) {
 
             // We get the mean of the frontier conditions for them to align
             // to the chunk that will need their information
-            fixFrontierConditions(lastIteration,
+            fixFrontierConditions(grids.front(),
                                   isIsolated,
                                   rowIndex[i],
                                   columnIndex[i],
@@ -263,21 +872,24 @@ namespace anpi {
             // OpenMP work
 
             limit = size_t(pow(2, i + 1));
+            threads = parallel.threadsFor(pixels, limit);
 
+            anpi::Matrix<T, Alloc> &target = grids.back();
+            const anpi::Matrix<T, Alloc> &source = grids.front();
 
 
-            // lets activate OpenMP when the matrix has more than 100 rows and
+            // lets activate OpenMP when the plate is large enough and
             // the user says they want to use it
 #ifdef ANPI_ENABLE_OpenMP
-#pragma omp parallel for num_threads(4) if (isUsingOpenMP)
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
 #endif
-            for (size_t j = 0; j <= limit; ++j) {
+            for (size_t j = 0; j < limit; ++j) {
 
-                for (size_t k = 0; k <= limit; ++k) {
+                for (size_t k = 0; k < limit; ++k) {
 
                     // We calculate the value of a chunk delimited by the indexes
-                    operateOnChunk(operationMatrix,
-                                   lastIteration,
+                    operateOnChunk(target,
+                                   source,
                                    rowIndex(i, j),
                                    rowIndex(i, j + 1),
                                    columnIndex(i, k),
@@ -288,146 +900,156 @@ namespace anpi {
 
             }
 
-            // We make a copy of our matrix for the calculations of the next iteration
-            lastIteration = operationMatrix;
+            // The written grid is the state for the next iteration
+            grids.swap();
+            restoreBorders(grids.front(), borders);
 
         }
 
+        // When the last level finishes both grids hold the same plate, so the
+        // pixel by pixel phase only starts after a level of the next loop
+        bool isWarmupConverged = true;
+
 
-        // This is in case we can divide the matrix even more before running pixel by pixel
-        // that means operationMatrix.cols > operationMatrix.rows
-        if (operationMatrix.rows() != operationMatrix.cols()) {
-            size_t rowIndexRow = rowIndex.rows() - 1;
+        // This is in case we can divide the longest side even more before
+        // running pixel by pixel, the shortest one stays on its finest division
+        if (grids.front().rows() != grids.front().cols()) {
             factor = 15; //this is to increase speed
-            size_t rowLimit = rowIndex.cols();
 
-            for (size_t i = rowIndexRow + 1; i < columnIndex.rows(); ++i) {
-                // We get the mean of the frontier conditions for them to align
-                // to the chunk that will need their information
-                fixFrontierConditions(lastIteration,
-                                      isIsolated,
-                                      rowIndex[rowIndexRow],
-                                      columnIndex[i],
-                                      size_t(pow(2, i) - 1));
+            const anpi::Matrix<T, Alloc> &shortIndex = isWide ? rowIndex : columnIndex;
+            const anpi::Matrix<T, Alloc> &longIndex = isWide ? columnIndex : rowIndex;
+            const size_t shortLevel = shortIndex.rows() - 1;
+            const size_t shortChunks = shortIndex.cols() - 1;
+
+            // The borders of the shortest side keep the chunks of its first level
+            // here, its index row has no more entries
+            const size_t shortSizes = size_t(pow(2, shortLevel + 1) - 1);
+
+            for (size_t i = shortLevel + 1; i < longIndex.rows(); ++i) {
+                const size_t longSizes = size_t(pow(2, i) - 1);
+                const size_t rowLevel = isWide ? shortLevel : i;
+                const size_t columnLevel = isWide ? i : shortLevel;
 
                 // we need to save the limit in a variable in order to make
                 // OpenMP work
                 limit = size_t(pow(2, i + 1));
+                const size_t rowChunks = isWide ? shortChunks : limit;
+                const size_t columnChunks = isWide ? limit : shortChunks;
+
+                // We get the mean of the frontier conditions for them to align
+                // to the chunk that will need their information
+                fixFrontierConditions(grids.front(),
+                                      isIsolated,
+                                      rowIndex[rowLevel],
+                                      columnIndex[columnLevel],
+                                      isWide ? std::min(longSizes, shortSizes) : longSizes,
+                                      isWide ? longSizes : std::min(longSizes, shortSizes));
 
-                // lets activate OpenMP when the matrix has more than 100 rows and
+                threads = parallel.threadsFor(pixels, rowChunks);
+
+                anpi::Matrix<T, Alloc> &target = grids.back();
+                const anpi::Matrix<T, Alloc> &source = grids.front();
+
+                // lets activate OpenMP when the plate is large enough and
                 // the user says they want to use it
 #ifdef ANPI_ENABLE_OpenMP
-#pragma omp parallel for num_threads(4) if (isUsingOpenMP)
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
 #endif
-                for (size_t j = 0; j < rowLimit; ++j) {
+                for (size_t j = 0; j < rowChunks; ++j) {
 
-                    for (size_t k = 0; k <= limit; ++k) {
+                    for (size_t k = 0; k < columnChunks; ++k) {
 
                         // We calculate the value of a chunk delimited by the indexes
-                        operateOnChunk(operationMatrix,
-                                       lastIteration,
-                                       rowIndex(rowIndexRow, j),
-                                       rowIndex(rowIndexRow, j + 1),
-                                       columnIndex(i, k),
-                                       columnIndex(i, k + 1),
+                        operateOnChunk(target,
+                                       source,
+                                       rowIndex(rowLevel, j),
+                                       rowIndex(rowLevel, j + 1),
+                                       columnIndex(columnLevel, k),
+                                       columnIndex(columnLevel, k + 1),
                                        lambda);
 
                     }
 
                 }
 
-                // We make a copy of our matrix for the calculations of the next iteration
-                if (i + 1 < columnIndex.rows()) {
-                    lastIteration = operationMatrix;
-                }
-
+                // The written grid is the state for the next iteration, the
+                // read one keeps the previous state to compare with
+                grids.swap();
+                restoreBorders(grids.front(), borders);
+                isWarmupConverged = false;
 
             }
         }
 
-        T ip1, im1, jp1, jm1;
-        //operationMatrix.print('O');
-        // Finally we make and individual pixel run until convergence is achieved
-        // Reduce the factor to increase precision
-        while (!operationMatrix.hasConverged(lastIteration, factor)) {
-            T newValue;
-            lastIteration = operationMatrix;
-
-            for (size_t i = 1; i < operationMatrix.rows() - 1; ++i) {
-
-                for (size_t j = 1; j < operationMatrix.cols() - 1; ++j) {
+        // The isolation is resolved once into the weights of the stencil,
+        // so the rows are swept without branching on each pixel
+        const StencilWeights<T> weights = isolationWeights<T>(isIsolated);
 
-                    // Top and bot isolation
-                    if(isIsolated.at(0)){
-                        ip1 = lastIteration(i - 1, j);
-                    }
-                    else{
-                        ip1 = lastIteration(i + 1, j);
-                    }
-                    if(isIsolated.at(1)){
-                        im1 = lastIteration(i + 1, j);
-                    }
-                    else{
-                        im1 = lastIteration(i - 1, j);
-                    }
-
-                    // left and right
-                    if(isIsolated.at(2)){
-                        jp1 = lastIteration(i, j + 1);
-                    }
-                    else{
-                        jp1 = lastIteration(i, j - 1);
-                    }
-                    if(isIsolated.at(3)){
-                        jm1 = lastIteration(i, j - 1);
-                    }
-                    else{
-                        jm1 = lastIteration(i, j + 1);
-                    }
+        // The red-black ordering updates the pixels in place, so it neither
+        // needs the copy of the last iteration nor a full matrix comparison
+        if (options.method == LiebmannMethod::RedBlackSOR) {
+            sorRelaxation(grids.front(), isIsolated, T(options.tolerance), options, parallel);
+        }
 
-                    newValue = (ip1 + im1 + jp1 + jm1) / 4;
+        // Finally we make and individual pixel run until convergence is achieved
+        // Reduce the factor to increase precision. The sweeps measure their own
+        // change, so after the first comparison with the warmup no other pass over
+        // the matrix is needed
+        if (options.method == LiebmannMethod::Jacobi && !isWarmupConverged &&
+            !grids.front().hasConverged(grids.back(), factor)) {
 
-                    operationMatrix(i, j) = lambda * newValue + (1 - lambda) * lastIteration(i, j);
+            // The sweeps never write the borders of the back grid
+            restoreBorders(grids.back(), borders);
 
-                }
-            }
+            jacobiRelaxation(grids, weights, lambda, std::numeric_limits<T>::epsilon() * T(pow(10, factor)),
+                             options, parallel);
         }
 
+        operationMatrix = grids.release(workspace.back);
 
-        //  If the matrix was transposed we return it as it was
-        if (isTransposed) {
-            operationMatrix = operationMatrix.copyTransposed();
-        }
+    }
+
+    /**
+     * Auxiliary function to Liebmann(*) with buffers of its own
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param operationMatrix   : Matrix in the which we will write our calculations
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param lambda            : Relaxation coefficient
+     * @param isUsingOpenMP     : Flag to activate openMP
+     * @param options           : Method and convergence parameters of the pixel by pixel phase
+     */
+    template<typename T, class Alloc>
+    void liebmannAux(anpi::Matrix<T, Alloc> &operationMatrix,
+                     const std::vector<bool> &isIsolated,
+                     const T lambda,
+                     const bool isUsingOpenMP = true,
+                     const LiebmannOptions &options = LiebmannOptions()) {
 
+        LiebmannWorkspace<T, Alloc> workspace;
+        liebmannAux(operationMatrix, isIsolated, lambda, isUsingOpenMP, options, workspace);
     }
 
 
     /**
-     * Master function it takes the frontier conditions and the isolation vector to get the average of
-     * vales and set it as the initial value for all the matrix
+     * Initial value of the inner pixels: the average of the borders that are
+     * not isolated, an isolated border takes the opposite one instead
+     *
      * @tparam T                : Data type
      * @tparam Alloc            : Allocator used for row allignment in the matrix values
      * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
      * @param verticalLength    : Number of rows in the operation matrix
      * @param horizontalLength  : Number of columns in the operation matrix
      * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
-     * @param lambda            : Relaxation coefficient
-     * @param isUsingOpenMP     : Flag signaling the use of OpenMP
-     * @return                  : A matrix with the heat distribution given the border conditions
+     * @return                  : Average of the frontier conditions
      */
     template<typename T, class Alloc>
-    anpi::Matrix<T, Alloc> liebmann(anpi::Matrix<T, Alloc> &frontierConditions,
-                                    const size_t verticalLength,
-                                    const size_t horizontalLength,
-                                    const std::vector<bool> isIsolated,
-                                    T lambda = 1,
-                                    const bool isUsingOpenMP = true) {
-
-        // The +2 is added to insert the frontierConditions into the matrix
-        const size_t cols = horizontalLength + 2;
-        const size_t rows = verticalLength + 2;
+    T averageFrontier(anpi::Matrix<T, Alloc> &frontierConditions,
+                      const size_t verticalLength,
+                      const size_t horizontalLength,
+                      const std::vector<bool> &isIsolated) {
 
-        // Lets initialize the result matrix
         T averageFrontierCondition = 0;
         T numBorders = 0;
 
@@ -480,30 +1102,239 @@ namespace anpi {
         // cal the average
         averageFrontierCondition /= numBorders;
 
-        anpi::Matrix<T, Alloc> operationMatrix = anpi::Matrix<T, Alloc>(rows, cols, averageFrontierCondition);
+        return averageFrontierCondition;
+    }
+
+
+    /**
+     * Builds the initial state of the plate: the frontier conditions are copied
+     * into the borders and the inner pixels take the average of the borders
+     * that are not isolated
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param operationMatrix   : Resized to (verticalLength + 2) x (horizontalLength + 2) pixels, its memory is
+     *                            reused when it already has that size. Its data type may be a storage type
+     *                            of T, such as bfloat16 for float
+     */
+    template<typename T, class Alloc, typename S, class SAlloc>
+    void initializePlate(anpi::Matrix<T, Alloc> &frontierConditions,
+                         const size_t verticalLength,
+                         const size_t horizontalLength,
+                         const std::vector<bool> &isIsolated,
+                         anpi::Matrix<S, SAlloc> &operationMatrix) {
+
+        // The +2 is added to insert the frontierConditions into the matrix
+        const size_t cols = horizontalLength + 2;
+        const size_t rows = verticalLength + 2;
+
+        // Lets initialize the result matrix
+        const T averageFrontierCondition = averageFrontier(frontierConditions,
+                                                           verticalLength,
+                                                           horizontalLength,
+                                                           isIsolated);
+
+        operationMatrix.allocate(rows, cols);
+        operationMatrix.fill(S(averageFrontierCondition));
 
         // We set the top and bottom conditions
         // the first and last columns are ignored
         // because they are frontier conditions
         for (size_t j = 1; j < cols - 1; ++j) {
-            operationMatrix(0, j) = frontierConditions(0, j - 1);           // Top condition is copied
-            operationMatrix(rows - 1, j) = frontierConditions(1, j - 1);    // Bottom condition is copied
+            operationMatrix(0, j) = S(frontierConditions(0, j - 1));           // Top condition is copied
+            operationMatrix(rows - 1, j) = S(frontierConditions(1, j - 1));    // Bottom condition is copied
         }
 
         // Lets now continue with the left and right
         for (size_t i = 1; i < rows - 1; ++i) {
-            operationMatrix(i, 0) = frontierConditions(2, i - 1);           // Left condition is copied
-            operationMatrix(i, cols - 1) = frontierConditions(3, i - 1);    // Right condition is copied
+            operationMatrix(i, 0) = S(frontierConditions(2, i - 1));           // Left condition is copied
+            operationMatrix(i, cols - 1) = S(frontierConditions(3, i - 1));    // Right condition is copied
+
+        }
+    }
+
+
+    /**
+     * Builds the initial state of the plate: the frontier conditions are copied
+     * into the borders and the inner pixels take the average of the borders
+     * that are not isolated
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @return                  : Matrix of (verticalLength + 2) x (horizontalLength + 2) pixels
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> initializePlate(anpi::Matrix<T, Alloc> &frontierConditions,
+                                           const size_t verticalLength,
+                                           const size_t horizontalLength,
+                                           const std::vector<bool> &isIsolated) {
+
+        anpi::Matrix<T, Alloc> operationMatrix;
+        initializePlate(frontierConditions, verticalLength, horizontalLength, isIsolated, operationMatrix);
+
+        return operationMatrix;
+    }
+
+
+    /**
+     * Resamples a plate to another resolution with bilinear interpolation.
+     * Both plates span the same area: their borders lie on the positions 0
+     * and n + 1 of each side, so the inner pixels are placed proportionally.
+     *
+     * @tparam T        : Data type
+     * @tparam Alloc    : Allocator used for row allignment in the matrix values
+     * @param plate     : Plate to resample, borders included
+     * @param rows      : Rows of the result, borders included
+     * @param cols      : Columns of the result, borders included
+     * @return          : Resampled plate, it is a copy when the size does not change
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> resamplePlate(const anpi::Matrix<T, Alloc> &plate,
+                                         const size_t rows,
+                                         const size_t cols) {
+
+        if (plate.rows() == rows && plate.cols() == cols) {
+            return plate;
+        }
+
+        if (plate.rows() < 2 || plate.cols() < 2 || rows < 2 || cols < 2) {
+            throw anpi::Exception("La placa debe tener al menos dos filas y dos columnas");
+        }
+
+        // Source position of each target column, reused by every row
+        const T colScale = T(plate.cols() - 1) / T(cols - 1);
+        std::vector<size_t> colCell(cols);
+        std::vector<T> colFraction(cols);
+        for (size_t j = 0; j < cols; ++j) {
+            const T position = T(j) * colScale;
+            colCell[j] = std::min(size_t(position), plate.cols() - 2);
+            colFraction[j] = position - T(colCell[j]);
+        }
 
+        const T rowScale = T(plate.rows() - 1) / T(rows - 1);
+        anpi::Matrix<T, Alloc> result(rows, cols, anpi::DoNotInitialize);
+
+        for (size_t i = 0; i < rows; ++i) {
+            const T position = T(i) * rowScale;
+            const size_t cell = std::min(size_t(position), plate.rows() - 2);
+            const T fraction = position - T(cell);
+            const T *up = plate[cell];
+            const T *down = plate[cell + 1];
+            T *row = result[i];
+
+            for (size_t j = 0; j < cols; ++j) {
+                const size_t c = colCell[j];
+                const T f = colFraction[j];
+                const T top = up[c] + f * (up[c + 1] - up[c]);
+                const T bottom = down[c] + f * (down[c + 1] - down[c]);
+                row[j] = top + fraction * (bottom - top);
+            }
         }
 
-        liebmannAux(operationMatrix, isIsolated, lambda, isUsingOpenMP);
+        return result;
+    }
+
+
+    /**
+     * Master function it takes the frontier conditions and the isolation vector to get the average of
+     * vales and set it as the initial value for all the matrix
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param lambda            : Relaxation coefficient
+     * @param isUsingOpenMP     : Flag signaling the use of OpenMP
+     * @param options           : Method and convergence parameters of the pixel by pixel phase
+     * @return                  : A matrix with the heat distribution given the border conditions
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> liebmann(anpi::Matrix<T, Alloc> &frontierConditions,
+                                    const size_t verticalLength,
+                                    const size_t horizontalLength,
+                                    const std::vector<bool> &isIsolated,
+                                    T lambda = 1,
+                                    const bool isUsingOpenMP = true,
+                                    const LiebmannOptions &options = LiebmannOptions()) {
+
+        anpi::Matrix<T, Alloc> operationMatrix = initializePlate(frontierConditions,
+                                                                 verticalLength,
+                                                                 horizontalLength,
+                                                                 isIsolated);
+
+        liebmannAux(operationMatrix, isIsolated, lambda, isUsingOpenMP, options);
 
         return operationMatrix;
 
     }
 
 
+    /**
+     * Warm started Liebmann: the inner pixels start from a previous solution
+     * instead of the average of the borders, and the chunk warmup is skipped
+     * because the guess is already close to the result. The pixel phase
+     * converges with options.tolerance for both methods.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param initialGuess      : Previous plate, borders included, it is resampled when its size differs
+     * @param lambda            : Relaxation coefficient
+     * @param isUsingOpenMP     : Flag signaling the use of OpenMP
+     * @param options           : Method and convergence parameters of the pixel by pixel phase
+     * @return                  : A matrix with the heat distribution given the border conditions
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> liebmann(anpi::Matrix<T, Alloc> &frontierConditions,
+                                    const size_t verticalLength,
+                                    const size_t horizontalLength,
+                                    const std::vector<bool> &isIsolated,
+                                    const anpi::Matrix<T, Alloc> &initialGuess,
+                                    T lambda = 1,
+                                    const bool isUsingOpenMP = true,
+                                    const LiebmannOptions &options = LiebmannOptions()) {
+
+        // The borders come from the new frontier conditions, the inner
+        // pixels from the guess
+        anpi::Matrix<T, Alloc> operationMatrix = initializePlate(frontierConditions,
+                                                                 verticalLength,
+                                                                 horizontalLength,
+                                                                 isIsolated);
+        const anpi::Matrix<T, Alloc> guess = resamplePlate(initialGuess,
+                                                           operationMatrix.rows(),
+                                                           operationMatrix.cols());
+
+        for (size_t i = 1; i < operationMatrix.rows() - 1; ++i) {
+            std::memcpy(operationMatrix[i] + 1, guess[i] + 1, sizeof(T) * (operationMatrix.cols() - 2));
+        }
+
+        ParallelOptions parallel = options.parallel;
+        parallel.isUsingOpenMP = parallel.isUsingOpenMP && isUsingOpenMP;
+
+        if (options.method == LiebmannMethod::RedBlackSOR) {
+            sorRelaxation(operationMatrix, isIsolated, T(options.tolerance), options, parallel);
+            return operationMatrix;
+        }
+
+        PingPong<T, Alloc> grids(std::move(operationMatrix));
+        jacobiRelaxation(grids, isolationWeights<T>(isIsolated), lambda, T(options.tolerance), options, parallel);
+
+        return grids.release();
+    }
+
+
 } //namespace anpi
 
 
@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_LIEBMANN_BATCH_H
+#define ANPI_LIEBMANN_BATCH_H
+
+
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include "Matrix.hpp"
+#include "Exception.hpp"
+#include "Liebmann.hpp"
+#include "ParallelOptions.hpp"
+
+namespace anpi {
+
+    /**
+     * Frontier conditions of one plate of a batch, with the same meaning as
+     * the arguments of anpi::liebmann
+     *
+     * @tparam T        :   Data type
+     * @tparam Alloc    :   Allocator used for row allignment in the matrix values
+     */
+    template<typename T, class Alloc = anpi::aligned_row_allocator<T> >
+    struct PlateProblem {
+        /// Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+        anpi::Matrix<T, Alloc> frontierConditions;
+
+        /// Number of rows in the operation matrix
+        size_t verticalLength = 0;
+
+        /// Number of columns in the operation matrix
+        size_t horizontalLength = 0;
+
+        /// Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+        std::vector<bool> isIsolated = {false, false, false, false};
+    };
+
+
+    /**
+     * Solves many independent plates, one plate per thread at a time. The
+     * plates are small, so the threads of a single plate would mostly wait on
+     * each other; instead each plate is solved serially with the same
+     * algorithm as anpi::liebmann, and gives the same result. The plates are
+     * split among the threads with the schedule of options.parallel, Dynamic
+     * balances plates of different sizes.
+     *
+     * Each plate is built directly in its result matrix, so a results vector
+     * kept between batches of plates of the same sizes is reused. Each thread
+     * keeps one LiebmannWorkspace for all its plates, so the back grid, the
+     * chunk indexes and the borders are only reallocated when the size of
+     * the plate changes.
+     *
+     * @tparam T            : Data type
+     * @tparam Alloc        : Allocator used for row allignment in the matrix values
+     * @param problems      : Frontier conditions of each plate
+     * @param results       : Heat distribution of each plate, resized to the number of problems
+     * @param lambda        : Relaxation coefficient
+     * @param options       : Method and convergence parameters of the pixel by pixel phase
+     */
+    template<typename T, class Alloc>
+    void liebmannBatch(std::vector<PlateProblem<T, Alloc> > &problems,
+                       std::vector<anpi::Matrix<T, Alloc> > &results,
+                       const T lambda = 1,
+                       const LiebmannOptions &options = LiebmannOptions()) {
+
+        // Exceptions can not leave the parallel region, so the problems are
+        // checked before it starts
+        size_t pixels = 0;
+        for (const PlateProblem<T, Alloc> &problem : problems) {
+            const std::vector<bool> &isolation = problem.isIsolated;
+
+            if (isolation.size() != 4) {
+                throw anpi::Exception("El vector de aislamiento debe tener cuatro bordes");
+            }
+            if (isolation[0] && isolation[1] && isolation[2] && isolation[3]) {
+                throw anpi::Exception("El sistema esta completamente aislado");
+            }
+            if (problem.verticalLength == 0 || problem.horizontalLength == 0 ||
+                problem.frontierConditions.rows() < 4 ||
+                problem.frontierConditions.cols() < std::max(problem.verticalLength, problem.horizontalLength)) {
+                throw anpi::Exception("Las condiciones de frontera no cubren la placa");
+            }
+
+            pixels += (problem.verticalLength + 2) * (problem.horizontalLength + 2);
+        }
+
+        results.resize(problems.size());
+
+        // Each plate is solved by a single thread, and the history of a
+        // single plate has no meaning on a batch
+        LiebmannOptions plateOptions = options;
+        plateOptions.residualHistory = nullptr;
+        plateOptions.parallel.isUsingOpenMP = false;
+
+        const int threads = options.parallel.threadsFor(pixels, problems.size());
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel num_threads(threads) if (threads > 1)
+#endif
+        {
+            LiebmannWorkspace<T, Alloc> workspace;
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp for schedule(runtime)
+#endif
+            for (size_t k = 0; k < problems.size(); ++k) {
+                PlateProblem<T, Alloc> &problem = problems[k];
+
+                initializePlate(problem.frontierConditions,
+                                problem.verticalLength,
+                                problem.horizontalLength,
+                                problem.isIsolated,
+                                results[k]);
+
+                liebmannAux(results[k], problem.isIsolated, lambda, false, plateOptions, workspace);
+            }
+        }
+    }
+
+
+} //namespace anpi
+
+
+#endif //ANPI_LIEBMANN_BATCH_H
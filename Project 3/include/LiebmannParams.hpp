@@ -6,8 +6,15 @@
 #define PROYECTO3_LIEBMANNPARAMS_H
 
 #include <vector>
+#include <string>
 #include <IsolationContainer.hpp>
 #include <Liebmann.hpp>
+#include <Multigrid.hpp>
+#include <ConjugateGradient.hpp>
+#include <MixedPrecision.hpp>
+#include <AdaptiveLiebmann.hpp>
+#include <ParallelOptions.hpp>
+#include <Exception.hpp>
 #include <Interpolation.hpp>
 #include <Matrix.hpp>
 
@@ -19,6 +26,14 @@ public:
     int height{}, width{};
     //vector con los perfiles de temperatura
     std::vector<double> topProfile, botProfile, leftProfile, rightProfile;
+    //metodo de solucion (jacobi, sor, mixta, multigrid, cg, adaptativa), ciclo de multigrid (V, W)
+    //y precondicionador del gradiente conjugado (jacobi, cholesky)
+    std::string method = "jacobi", cycle = "V", preconditioner = "cholesky";
+    //diferencia de temperatura a partir de la cual el metodo adaptativo divide una celda
+    double refinement = 1;
+    //hilos, planificacion y umbral serial de las regiones de OpenMP
+    anpi::ParallelOptions parallel;
+    std::string schedule = "static";
     anpi::Matrix<double> borders;
     const size_t rowCount=4;
 
@@ -68,8 +83,61 @@ public:
         fillBorderMatrix(leftBorderVec, 2);
         fillBorderMatrix(rightBorderVec, 3);
 
+        if (schedule == "dynamic") {
+            parallel.schedule = anpi::ParallelSchedule::Dynamic;
+        } else if (schedule == "guided") {
+            parallel.schedule = anpi::ParallelSchedule::Guided;
+        } else if (schedule == "static") {
+            parallel.schedule = anpi::ParallelSchedule::Static;
+        } else {
+            throw anpi::Exception("planificacion debe ser static, dynamic o guided");
+        }
+
+        if (method == "multigrid") {
+            anpi::MultigridOptions options;
+            options.parallel = parallel;
+            if (cycle == "W") {
+                options.cycle = anpi::MultigridCycle::W;
+            } else if (cycle != "V") {
+                throw anpi::Exception("ciclo de multigrid debe ser V o W");
+            }
+            std::cout<<"calculando multigrid..........\n";
+            return anpi::multigrid(borders, (size_t)height, (size_t)width, isolationVector, options);
+        }
+
+        if (method == "cg") {
+            anpi::CGOptions options;
+            options.parallel = parallel;
+            if (preconditioner == "jacobi") {
+                options.preconditioner = anpi::CGPreconditioner::Jacobi;
+            } else if (preconditioner != "cholesky") {
+                throw anpi::Exception("precondicionador debe ser jacobi o cholesky");
+            }
+            std::cout<<"calculando gradiente conjugado..........\n";
+            return anpi::conjugateGradient(borders, (size_t)height, (size_t)width, isolationVector, options);
+        }
+
+        if (method == "adaptativa") {
+            anpi::AdaptiveOptions options;
+            options.parallel = parallel;
+            options.threshold = refinement;
+            std::cout<<"calculando liebmann adaptativo..........\n";
+            return anpi::adaptiveLiebmann(borders, (size_t)height, (size_t)width, isolationVector, options);
+        }
+
+        anpi::LiebmannOptions options;
+        options.parallel = parallel;
+        if (method == "mixta") {
+            std::cout<<"calculando liebmann en precision mixta..........\n";
+            return anpi::mixedPrecisionLiebmann(borders, (size_t)height, (size_t)width, isolationVector, true, options);
+        }
+        if (method == "sor") {
+            options.method = anpi::LiebmannMethod::RedBlackSOR;
+        } else if (method != "jacobi") {
+            throw anpi::Exception("metodo debe ser jacobi, sor, mixta, multigrid, cg o adaptativa");
+        }
         std::cout<<"calculando liebmann..........\n";
-        return anpi::liebmann(borders, (size_t)height, (size_t)width, isolationVector);
+        return anpi::liebmann(borders, (size_t)height, (size_t)width, isolationVector, 1., true, options);
 
     }
 
@@ -21,6 +21,8 @@
 
 #include <AnpiConfig.hpp>
 #include <Allocator.hpp>
+#include <ParallelOptions.hpp>
+#include "bits/MatrixExpression.hpp"
 
 #include <typeinfo>
 
@@ -185,6 +187,17 @@ namespace anpi {
         Matrix(std::initializer_list<std::initializer_list<value_type> > _lst,
                const allocator_type &_a);
 
+        /**
+         * Evaluates an element-wise expression of matrices in a single
+         * pass, see anpi::expr
+         *
+         * \code
+         * anpi::Matrix<float> c = lambda * a + (1 - lambda) * b;
+         * \endcode
+         */
+        template<class E>
+        Matrix(const expr::Expression<E> &_expression);
+
         //@}
 
         /**
@@ -203,6 +216,13 @@ namespace anpi {
          */
         Matrix<T, Alloc> &operator=(Matrix<T, Alloc> &&other);
 
+        /**
+         * Evaluates an element-wise expression of matrices in a single
+         * pass. The expression may read this matrix
+         */
+        template<class E>
+        Matrix<T, Alloc> &operator=(const expr::Expression<E> &expression);
+
         /**
          * Compare two matrices for equality
          *
@@ -246,7 +266,9 @@ namespace anpi {
         }
 
         /**
-         * Swap the contents of the other matrix with this one
+         * Swap the contents of the other matrix with this one. The
+         * allocators are swapped as well, so each block of memory is
+         * released by the allocator that reserved it
          */
         void swap(Matrix<T, Alloc> &other);
 
@@ -266,6 +288,12 @@ namespace anpi {
          */
         void fill(const T val);
 
+        /**
+         * Fill all elements of the matrix with the given value, splitting
+         * the rows among the threads as given by the options
+         */
+        void fill(const T val, const ParallelOptions &parallel);
+
         /**
          * Fill all elements of the matrix with the given memory block
          *
@@ -330,6 +358,24 @@ namespace anpi {
          */
         inline const T *data() const { return this->_impl._data; }
 
+        /**
+         * Copy of the allocator in use
+         */
+        inline allocator_type get_allocator() const noexcept {
+            return _get_allocator();
+        }
+
+        /**
+         * Allocator for the copies of this matrix and the results of
+         * operations on it. It reserves the same kind of memory, but never
+         * the storage of this matrix, e.g. a file backed allocator gives
+         * anonymous pages
+         */
+        inline allocator_type resultAllocator() const noexcept {
+            return std::allocator_traits<allocator_type>::
+            select_on_container_copy_construction(_get_allocator());
+        }
+
         /**
          * Extract one particular column
          *
@@ -354,12 +400,16 @@ namespace anpi {
         void print(char name = 'M');
 
         /// Checks if the difference of the matrix and the reference is smaller than a threshold
-        bool hasConverged(Matrix<T, Alloc> reference, T factor = 1);
+        bool hasConverged(const Matrix<T, Alloc> &reference, T factor = 1) const;
 
-        //void transpose();
+        /**
+         * Transposes the matrix. Square matrices are transposed in place,
+         * otherwise the transposed copy replaces the data of the matrix
+         */
+        void transpose();
 
         /// Creates a copy of the transposed matrix and returns it
-        Matrix<T, Alloc> copyTransposed();
+        Matrix<T, Alloc> copyTransposed() const;
 
         /**
          * @name Arithmetic operators
@@ -372,10 +422,26 @@ namespace anpi {
         /// Subtract another matrix to this one, and leave the result in here
         Matrix &operator-=(const Matrix &other);
 
+        /// Sum an expression to this matrix in a single pass
+        template<class E>
+        Matrix &operator+=(const expr::Expression<E> &expression);
+
+        /// Subtract an expression to this matrix in a single pass
+        template<class E>
+        Matrix &operator-=(const expr::Expression<E> &expression);
+
 
         Matrix &operator*=(const Matrix &other);
 
+        /// Multiply all the entries of this matrix by a scalar
+        template<typename U,
+                typename std::enable_if<std::is_arithmetic<U>::value, int>::type = 0>
+        Matrix &operator*=(const U factor);
 
+        /// Divide all the entries of this matrix by a non-zero scalar
+        template<typename U,
+                typename std::enable_if<std::is_arithmetic<U>::value, int>::type = 0>
+        Matrix &operator/=(const U factor);
 
         //@}
 
@@ -403,13 +469,9 @@ namespace anpi {
 
     /// @name External arithmetic operators for matrices
     //@{
-    template<typename T, class Alloc>
-    Matrix<T, Alloc> operator+(const Matrix<T, Alloc> &a,
-                               const Matrix<T, Alloc> &b);
 
-    template<typename T, class Alloc>
-    Matrix<T, Alloc> operator-(const Matrix<T, Alloc> &a,
-                               const Matrix<T, Alloc> &b);
+    // The sums, differences, products and quotients by a scalar are the
+    // lazy expressions of anpi::expr
 
     // Tarea 4
     template<typename T, typename U, class Alloc>
@@ -417,28 +479,54 @@ namespace anpi {
                                const Matrix<U, Alloc> &b);
 
     // Tarea 4
-    template<typename T, typename U, class Alloc>
+    template<typename T, class Alloc>
     std::vector<T> operator*(const Matrix<T, Alloc> &a,
                              const std::vector<T> &b);
     /*template<typename T, typename U, class Alloc>
     std::vector<T> operator*=(const Matrix<T,Alloc>& a,
                              const std::vector<U>& b);*/
 
-    //Multiplicación por un escalar
-    template<typename T, typename U, class Alloc>
-    Matrix<T, Alloc> operator*(const U factor,
-                               const Matrix<T, Alloc> &a);
+    /// Product y = a*x into the vector of the caller, resized only if needed
+    template<typename T, class Alloc>
+    void multiplicate(const Matrix<T, Alloc> &a,
+                      const std::vector<T> &x,
+                      std::vector<T> &y,
+                      const ParallelOptions &parallel = ParallelOptions());
 
-    //División por un escalar
-    template<typename T, typename U, class Alloc>
-    Matrix<T> operator/(const Matrix<T, Alloc> &a,
-                        const U factor);
+    /// Product y = a^T*x into the vector of the caller, resized only if needed
+    template<typename T, class Alloc>
+    void multiplicateTransposed(const Matrix<T, Alloc> &a,
+                                const std::vector<T> &x,
+                                std::vector<T> &y,
+                                const ParallelOptions &parallel = ParallelOptions());
 
     //Comparación entre matrices
     template<typename T, typename U, class Alloc>
     bool operator>=(const Matrix<T, Alloc> &a,
                     const Matrix<U, Alloc> &b);
 
+    // The element-wise operators and the reductions split the rows among
+    // the threads as given by anpi::elementWiseParallel(). The following
+    // functions take the options of a single call instead
+
+    /// Evaluate an expression into c, resized only if needed
+    template<typename T, class Alloc, class E>
+    void evaluate(Matrix<T, Alloc> &c,
+                  const expr::Expression<E> &expression,
+                  const ParallelOptions &parallel);
+
+    /// Sum of the entries of a matrix or an expression
+    template<class E,
+            typename std::enable_if<expr::operand<E>::value, int>::type = 0>
+    typename expr::operand<E>::type::value_type
+    sum(const E &e, const ParallelOptions &parallel = elementWiseParallel());
+
+    /// Largest magnitude of the entries of a matrix or an expression
+    template<class E,
+            typename std::enable_if<expr::operand<E>::value, int>::type = 0>
+    typename expr::operand<E>::type::value_type
+    maxAbs(const E &e, const ParallelOptions &parallel = elementWiseParallel());
+
 
 
     //@}
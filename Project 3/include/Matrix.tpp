@@ -130,7 +130,7 @@ namespace anpi {
 
     template<typename T, class Alloc>
     Matrix<T, Alloc>::Matrix(const Matrix<T, Alloc> &_other)
-            : Matrix(_other.rows(), _other.cols(), DoNotInitialize) {
+            : Matrix(_other.rows(), _other.cols(), DoNotInitialize, _other.resultAllocator()) {
 
         fill(_other.data());
     }
@@ -182,6 +182,17 @@ namespace anpi {
     Matrix<T, Alloc>::Matrix(allocator_type &&_a) noexcept
             : _impl(std::move(_a)) {}
 
+    template<typename T, class Alloc>
+    template<class E>
+    Matrix<T, Alloc>::Matrix(const expr::Expression<E> &_expression)
+            : Matrix(_expression.self().rows(), _expression.self().cols(), DoNotInitialize,
+                     expr::resultAllocator<Alloc>(_expression.self())) {
+        static_assert(std::is_same<typename E::value_type, T>::value,
+                      "The expression must have the data type of the matrix");
+
+        ::anpi::aimpl::assign(*this, _expression.self());
+    }
+
 
     template<typename T, class Alloc>
     Matrix<T, Alloc>::~Matrix() noexcept {
@@ -209,11 +220,26 @@ namespace anpi {
     Matrix<T, Alloc> &Matrix<T, Alloc>::operator=(Matrix<T, Alloc> &&other) {
         if (this->data() != other.data()) { // alias detection first
             this->_impl._swap_data(other._impl);
+            std::swap(this->_get_allocator(), other._get_allocator());
         }
         other.clear();
         return *this;
     }
 
+    template<typename T, class Alloc>
+    template<class E>
+    Matrix<T, Alloc> &Matrix<T, Alloc>::operator=(const expr::Expression<E> &expression) {
+        static_assert(std::is_same<typename E::value_type, T>::value,
+                      "The expression must have the data type of the matrix");
+
+        // An expression that reads this matrix has its size, so the
+        // allocation keeps the data it reads
+        allocate(expression.self().rows(), expression.self().cols());
+        ::anpi::aimpl::assign(*this, expression.self());
+
+        return *this;
+    }
+
     template<typename T, class Alloc>
     bool Matrix<T, Alloc>::operator==(const Matrix<T, Alloc> &other) const {
         if (&other == this) return true; // alias detection
@@ -250,6 +276,7 @@ namespace anpi {
     template<typename T, class Alloc>
     void Matrix<T, Alloc>::swap(Matrix<T, Alloc> &other) {
         this->_impl._swap_data(other._impl);
+        std::swap(this->_get_allocator(), other._get_allocator());
     }
 
 
@@ -345,12 +372,18 @@ namespace anpi {
 
     template<typename T, class Alloc>
     void Matrix<T, Alloc>::fill(const T val) {
-        T *end = this->_impl._data + (this->_impl._rows * this->_impl._dcols);
-        for (T *ptr = this->_impl._data; ptr != end; ++ptr) {
-            *ptr = val;
-        }
+        fill(val, elementWiseParallel());
+    }
+
+    template<typename T, class Alloc>
+    void Matrix<T, Alloc>::fill(const T val, const ParallelOptions &parallel) {
+        // The padding is filled as well, so the rows are written whole
+        const size_t dcols = this->_impl._dcols;
+        T *const data = this->_impl._data;
 
-        // ACCELERATE ME!
+        ::anpi::fallback::forRows(this->_impl._rows, dcols, parallel, [&](const size_t i) {
+            std::fill(data + i * dcols, data + (i + 1) * dcols, val);
+        });
     }
 
     template<typename T, class Alloc>
@@ -436,36 +469,26 @@ namespace anpi {
         std::cout << std::endl;
     }
 
-    /*template<typename T, class Alloc>
+    template<typename T, class Alloc>
     void Matrix<T, Alloc>::transpose() {
 
-        anpi::Matrix<T> At = *this;
-        for (size_t i = 0; i < this->cols(); ++i) {
-
-            for (size_t j = 0; j < this->cols(); ++j) {
-                this->operator()(i, j) = At(j, i);
-            }
-
+        if (this->rows() == this->cols()) {
+            ::anpi::aimpl::transpose(*this);
+        } else {
+            // Copied back instead of swapped, so the matrix keeps its
+            // allocator, e.g. the file or the huge pages it maps
+            const Matrix<T, Alloc> At = this->copyTransposed();
+            *this = At;
         }
+    }
 
-    }*/
     template<typename T, class Alloc>
-    Matrix<T, Alloc> Matrix<T, Alloc>::copyTransposed() {
-
-        size_t cols = this->cols();
-        size_t rows = this->rows();
+    Matrix<T, Alloc> Matrix<T, Alloc>::copyTransposed() const {
 
-        anpi::Matrix<T> At = anpi::Matrix<T>(cols, rows);
-        for (size_t i = 0; i < cols; ++i) {
-
-            for (size_t j = 0; j < rows; ++j) {
-                At(i, j) = this->operator()(j, i);
-            }
-
-        }
+        Matrix<T, Alloc> At(this->cols(), this->rows(), anpi::DoNotInitialize, resultAllocator());
+        ::anpi::aimpl::transpose(*this, At);
 
         return At;
-
     }
 
 
@@ -516,21 +539,24 @@ namespace anpi {
     }
 
     template<typename T, class Alloc>
-    bool Matrix<T, Alloc>::hasConverged(Matrix<T, Alloc> reference, T factor) {
+    bool Matrix<T, Alloc>::hasConverged(const Matrix<T, Alloc> &reference, T factor) const {
 
-        T eps = std::numeric_limits<T>::epsilon() * pow(10, factor);
-        bool isConverging = true;
+        const T eps = std::numeric_limits<T>::epsilon() * pow(10, factor);
 
-        for (size_t i = 0; i < reference.rows() && isConverging; ++i) {
+        for (size_t i = 0; i < reference.rows(); ++i) {
 
-            for (size_t j = 0; j < reference.cols() && isConverging; ++j) {
-                isConverging = abs(this->operator()(i, j) - reference(i, j)) <= eps;
+            const T *here = this->operator[](i);
+            const T *other = reference[i];
 
+            for (size_t j = 0; j < reference.cols(); ++j) {
+                if (std::abs(here[j] - other[j]) > eps) {
+                    return false;
+                }
             }
 
         }
 
-        return isConverging;
+        return true;
 
     }
 
@@ -567,141 +593,140 @@ namespace anpi {
 
 
     template<typename T, class Alloc>
-    Matrix<T, Alloc> &Matrix<T, Alloc>::operator*=(const Matrix<T, Alloc> &other) {
-        ::anpi::fallback::multiplicate(*this, other);
+    template<class E>
+    Matrix<T, Alloc> &Matrix<T, Alloc>::operator+=(const expr::Expression<E> &expression) {
+
+        ::anpi::aimpl::assign(*this, *this + expression.self());
+
+        return *this;
+    }
+
+    template<typename T, class Alloc>
+    template<class E>
+    Matrix<T, Alloc> &Matrix<T, Alloc>::operator-=(const expr::Expression<E> &expression) {
+
+        ::anpi::aimpl::assign(*this, *this - expression.self());
+
         return *this;
     }
 
 
     template<typename T, class Alloc>
-    Matrix<T, Alloc> operator+(const Matrix<T, Alloc> &a,
-                               const Matrix<T, Alloc> &b) {
+    Matrix<T, Alloc> &Matrix<T, Alloc>::operator*=(const Matrix<T, Alloc> &other) {
+        ::anpi::aimpl::multiplicate(*this, other);
+        return *this;
+    }
 
-        assert((a.rows() == b.rows()) && (a.cols() == b.cols()));
+    template<typename T, class Alloc>
+    template<typename U,
+            typename std::enable_if<std::is_arithmetic<U>::value, int>::type>
+    Matrix<T, Alloc> &Matrix<T, Alloc>::operator*=(const U factor) {
 
-        Matrix<T, Alloc> c(a.rows(), a.cols(), anpi::DoNotInitialize);
-        ::anpi::aimpl::add(a, b, c);
-        return c;
+        ::anpi::aimpl::assign(*this, factor * (*this));
+
+        return *this;
     }
 
     template<typename T, class Alloc>
-    Matrix<T, Alloc> operator-(const Matrix<T, Alloc> &a,
-                               const Matrix<T, Alloc> &b) {
+    template<typename U,
+            typename std::enable_if<std::is_arithmetic<U>::value, int>::type>
+    Matrix<T, Alloc> &Matrix<T, Alloc>::operator/=(const U factor) {
 
-        assert((a.rows() == b.rows()) && (a.cols() == b.cols()));
+        ::anpi::aimpl::assign(*this, (*this) / factor);
 
-        Matrix<T, Alloc> c(a.rows(), a.cols(), anpi::DoNotInitialize);
-        ::anpi::aimpl::subtract(a, b, c);
-        return c;
+        return *this;
     }
 
+
     template<typename T, typename U, class Alloc>
     Matrix<T, Alloc> operator*(const Matrix<T, Alloc> &a,
                                const Matrix<U, Alloc> &b) {
 
-        Matrix<T, Alloc> c(a.rows(), a.cols(), anpi::DoNotInitialize);
-        ::anpi::fallback::multiplicate(a, b, c);
+        Matrix<T, Alloc> c(a.resultAllocator());
+        ::anpi::aimpl::multiplicate(a, b, c);
         return c;
 
     }
 
 
-    // TODO: Hacer simd
-    template<typename T, typename U, class Alloc>
+    template<typename T, class Alloc>
     std::vector<T> operator*(const Matrix<T, Alloc> &a,
-                             const std::vector<U> &b) {
+                             const std::vector<T> &b) {
+
+        std::vector<T> mult;
+        multiplicate(a, b, mult);
+        return mult;
+    }
+
+    template<typename T, class Alloc>
+    void multiplicate(const Matrix<T, Alloc> &a,
+                      const std::vector<T> &x,
+                      std::vector<T> &y,
+                      const ParallelOptions &parallel) {
         //Se verifica que las matriz y el vector sean
         // compatibles para realizar la multiplicacion
-        if (a.cols() != b.size()) {
+        if (a.cols() != x.size()) {
             throw anpi::Exception("Las dimensiones de la matriz y el vector no son compatibles");
-        } else {
-            //Se crea la matriz resultante y se inicializa en 0
-            T m = T(0);
-            std::vector<T> mult;
-
-            // Se hace la multiplicacion y se almacena
-            for (unsigned int i = 0; i < a.rows(); ++i) {
-
-                for (unsigned int j = 0; j < b.size(); ++j) {
-                    m += a(i, j) * b.at(j);
-                }
-
-                mult.push_back(m);
-                m = T(0);
-            }
-            return mult;
         }
-    }
 
+        assert(&x != &y);
 
-    //Implementación del producto matriz escalar
-    template<typename T, typename U, class Alloc>
-    Matrix<T, Alloc> operator*(const U factor,
-                               const Matrix<T, Alloc> &a) {
-        //Se crea la matriz resultante
-        Matrix<T> mult;
-        mult.allocate(a.rows(), a.cols());
-        T fact = T(factor);
-
-        //Se itera sobre cada elemnto de la matriz y se multiplica por el factor
-        for (unsigned int i = 0; i < a.rows(); ++i) {
-
-            for (unsigned int j = 0; j < a.cols(); ++j) {
-                mult(i, j) = fact * a(i, j);
-            }
-
-        }
-
-        return mult;
+        y.resize(a.rows());
+        ::anpi::aimpl::multiplicate(a, x.data(), y.data(), parallel);
     }
 
-    //Implementación de la división de una matriz por un escalar
-    //equivalente a multiplicar por el inverso del factor
-    template<typename T, typename U, class Alloc>
-    Matrix<T> operator/(const Matrix<T, Alloc> &a,
-                        const U factor) {
-
-
-        Matrix<T, Alloc> c(a.rows(), a.cols(), anpi::DoNotInitialize);
-
-        if (!std::is_same<T, float>::value && !std::is_same<T, double>::value) {
-            ::anpi::fallback::divide(a, c, factor);
-        } else {
-            const Matrix<T, Alloc> fact(a.rows(), a.cols(), T(factor));
-            ::anpi::simd::divide(a, fact, c);
+    template<typename T, class Alloc>
+    void multiplicateTransposed(const Matrix<T, Alloc> &a,
+                                const std::vector<T> &x,
+                                std::vector<T> &y,
+                                const ParallelOptions &parallel) {
+        //Se verifica que las matriz y el vector sean
+        // compatibles para realizar la multiplicacion
+        if (a.rows() != x.size()) {
+            throw anpi::Exception("Las dimensiones de la matriz y el vector no son compatibles");
         }
 
+        assert(&x != &y);
 
-        return c;
-
+        y.resize(a.cols());
+        ::anpi::aimpl::multiplicateTransposed(a, x.data(), y.data(), parallel);
     }
 
+
     template<typename T, typename U, class Alloc>
     bool operator>=(const Matrix<T, Alloc> &a,
                     const Matrix<U, Alloc> &b) {
-        if ((a.rows() != b.rows()) && (a.cols() != b.cols())) {
+        if ((a.rows() != b.rows()) || (a.cols() != b.cols())) {
             throw anpi::Exception("Las dimensiones de las matrices no son compatibles");
-        } else {
+        }
 
-            bool geq = true;
-            unsigned int i = 0;
-            unsigned int j = 0;
+        return ::anpi::aimpl::greaterEqual(a, b);
+    }
 
-            while (geq && (i < a.rows())) {
 
-                while (geq && (j < a.cols())) {
+    template<typename T, class Alloc, class E>
+    void evaluate(Matrix<T, Alloc> &c,
+                  const expr::Expression<E> &expression,
+                  const ParallelOptions &parallel) {
+        static_assert(std::is_same<typename E::value_type, T>::value,
+                      "The expression must have the data type of the matrix");
 
-                    geq = a(i, j) >= b(i, j);
-                    ++j;
-                }
-
-                j = 0;
-                ++i;
-            }
+        c.allocate(expression.self().rows(), expression.self().cols());
+        ::anpi::aimpl::assign(c, expression.self(), parallel);
+    }
 
-            return geq;
-        }
+    template<class E,
+            typename std::enable_if<expr::operand<E>::value, int>::type>
+    typename expr::operand<E>::type::value_type
+    sum(const E &e, const ParallelOptions &parallel) {
+        return ::anpi::aimpl::sum(expr::operand<E>::wrap(e), parallel);
+    }
 
+    template<class E,
+            typename std::enable_if<expr::operand<E>::value, int>::type>
+    typename expr::operand<E>::type::value_type
+    maxAbs(const E &e, const ParallelOptions &parallel) {
+        return ::anpi::aimpl::maxAbs(expr::operand<E>::wrap(e), parallel);
     }
 
 
@@ -0,0 +1,178 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_MIXED_PRECISION_H
+#define ANPI_MIXED_PRECISION_H
+
+
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include "Matrix.hpp"
+#include "Exception.hpp"
+#include "Liebmann.hpp"
+#include "ParallelOptions.hpp"
+
+namespace anpi {
+
+    /**
+     * Parameters of the sweeps made in low precision
+     */
+    struct MixedPrecisionOptions {
+        /// Multiple of the rounding of Low at the largest border where its sweeps stop
+        double roundingFactor = 16;
+
+        /// Sweeps without a new smallest change after which Low is taken as exhausted
+        size_t stagnationSweeps = 64;
+    };
+
+
+    namespace mpimpl {
+
+        /**
+         * Copies a matrix into another one of a different data type
+         *
+         * @tparam U        : Data type of the copy
+         * @tparam UAlloc   : Allocator of the copy
+         * @tparam T        : Data type of the original
+         * @tparam Alloc    : Allocator of the original
+         * @param from      : Original matrix
+         * @param to        : Copy, reallocated to the size of the original
+         */
+        template<typename U, class UAlloc, typename T, class Alloc>
+        void convert(const anpi::Matrix<T, Alloc> &from,
+                     anpi::Matrix<U, UAlloc> &to) {
+
+            to.allocate(from.rows(), from.cols());
+
+            for (size_t i = 0; i < from.rows(); ++i) {
+                const T *source = from[i];
+                U *here = to[i];
+                for (size_t j = 0; j < from.cols(); ++j) {
+                    here[j] = U(source[j]);
+                }
+            }
+        }
+
+    } // namespace mpimpl
+
+
+    /**
+     * Mixed precision Liebmann: the bulk of the relaxation is made in the
+     * Low data type, with twice the SIMD width and half the memory traffic
+     * of T, and the plate is finished in T. The chunk warmup of liebmannAux
+     * and red-black SOR sweeps run in Low until their change reaches
+     * mixed.roundingFactor times the rounding of Low at the largest border,
+     * or stops falling for mixed.stagnationSweeps sweeps. The plate is then
+     * copied into T and the SOR sweeps continue in T until options.tolerance.
+     *
+     * SOR damps the rounding left by Low as slowly as any other error, so
+     * the sweeps in T are not few: the sweeps saved are those that bring the
+     * plate down to the accuracy of Low.
+     *
+     * The relaxation is always red-black SOR, options.method is not used.
+     *
+     * @tparam Low              : Data type of the relaxation sweeps
+     * @tparam T                : Data type of the result
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param isUsingOpenMP     : Flag signaling the use of OpenMP
+     * @param options           : Convergence parameters of the sweeps in T
+     * @param mixed             : Parameters of the sweeps made in Low
+     * @return                  : A matrix with the heat distribution given the border conditions
+     */
+    template<typename Low = float, typename T, class Alloc>
+    anpi::Matrix<T, Alloc> mixedPrecisionLiebmann(anpi::Matrix<T, Alloc> &frontierConditions,
+                                                  const size_t verticalLength,
+                                                  const size_t horizontalLength,
+                                                  const std::vector<bool> &isIsolated,
+                                                  const bool isUsingOpenMP = true,
+                                                  const LiebmannOptions &options = LiebmannOptions(),
+                                                  const MixedPrecisionOptions &mixed = MixedPrecisionOptions()) {
+
+        typedef typename Alloc::template rebind<Low>::other LowAlloc;
+
+        ParallelOptions parallel = options.parallel;
+        parallel.isUsingOpenMP = parallel.isUsingOpenMP && isUsingOpenMP;
+
+        anpi::Matrix<T, Alloc> operationMatrix = initializePlate(frontierConditions,
+                                                                 verticalLength,
+                                                                 horizontalLength,
+                                                                 isIsolated);
+
+        // The chunk warmup of liebmannAux is made in Low, then the plate is
+        // relaxed in Low until the rounding of Low stops the sweeps
+        {
+            anpi::Matrix<Low, LowAlloc> lowFrontier;
+            mpimpl::convert(frontierConditions, lowFrontier);
+
+            LiebmannOptions warmup = options;
+            warmup.method = LiebmannMethod::RedBlackSOR;
+            warmup.maxIterations = 0;
+            warmup.residualHistory = nullptr;
+
+            anpi::Matrix<Low, LowAlloc> lowPlate = initializePlate(lowFrontier,
+                                                                   verticalLength,
+                                                                   horizontalLength,
+                                                                   isIsolated);
+            liebmannAux(lowPlate, isIsolated, Low(1), isUsingOpenMP, warmup);
+
+            const StencilWeights<Low> lowWeights = isolationWeights<Low>(isIsolated);
+            const Low omega = optimalOmega<Low>(lowPlate.rows(), lowPlate.cols(), isIsolated);
+
+            Low scale = Low(0);
+            for (size_t i = 0; i < lowFrontier.rows(); ++i) {
+                for (size_t j = 0; j < lowFrontier.cols(); ++j) {
+                    scale = std::max(scale, Low(std::abs(lowFrontier(i, j))));
+                }
+            }
+            const Low limit = std::max(Low(options.tolerance),
+                                       Low(mixed.roundingFactor) * std::numeric_limits<Low>::epsilon() * scale);
+
+            // The change of the SOR sweeps is not monotone, so the sweeps
+            // also stop once no new smallest change is seen for a while
+            Low smallest = std::numeric_limits<Low>::max();
+            size_t sinceSmallest = 0;
+            for (size_t s = 0; s < options.maxIterations; ++s) {
+                const Low change = redBlackSweep(lowPlate, lowWeights, omega, parallel).max;
+                if (change <= limit) {
+                    break;
+                }
+                if (change < smallest) {
+                    smallest = change;
+                    sinceSmallest = 0;
+                } else if (++sinceSmallest == mixed.stagnationSweeps) {
+                    break;
+                }
+            }
+
+            // The borders keep the values in T
+            for (size_t i = 1; i < operationMatrix.rows() - 1; ++i) {
+                for (size_t j = 1; j < operationMatrix.cols() - 1; ++j) {
+                    operationMatrix(i, j) = T(lowPlate(i, j));
+                }
+            }
+        }
+
+        sorRelaxation(operationMatrix, isIsolated, T(options.tolerance), options, parallel);
+
+        return operationMatrix;
+    }
+
+
+} //namespace anpi
+
+
+#endif //ANPI_MIXED_PRECISION_H
@@ -0,0 +1,795 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+
+#ifndef ANPI_MULTIGRID_H
+#define ANPI_MULTIGRID_H
+
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "Matrix.hpp"
+#include "Exception.hpp"
+#include "Liebmann.hpp"
+#include "HalfPrecision.hpp"
+#include "ParallelOptions.hpp"
+
+namespace anpi {
+
+    /**
+     * Recursion pattern of the multigrid cycle
+     */
+    enum class MultigridCycle {
+        /// One coarse grid correction per level
+        V,
+        /// Two coarse grid corrections per level
+        W
+    };
+
+
+    /**
+     * Relaxation used to smooth the error on every level
+     */
+    enum class MultigridSmoother {
+        /// Weighted Jacobi, uses an auxiliary grid per level
+        Jacobi,
+        /// In-place red-black ordered Gauss-Seidel
+        RedBlackGaussSeidel
+    };
+
+
+    /**
+     * Parameters of the multigrid solver
+     */
+    struct MultigridOptions {
+        /// V or W cycle
+        MultigridCycle cycle = MultigridCycle::V;
+
+        /// Relaxation used on every level
+        MultigridSmoother smoother = MultigridSmoother::RedBlackGaussSeidel;
+
+        /// Smoothing sweeps before the coarse grid correction
+        size_t preSmoothing = 2;
+
+        /// Smoothing sweeps after the coarse grid correction
+        size_t postSmoothing = 2;
+
+        /// Relaxation coefficient of the Jacobi smoother
+        double jacobiWeight = 0.8;
+
+        /// Grids with this amount of inner pixels or less are solved directly
+        size_t coarsestUnknowns = 64;
+
+        /// Largest residual of a pixel accepted as converged
+        double tolerance = 1e-4;
+
+        /// Maximum number of cycles
+        size_t maxCycles = 100;
+
+        /// Cycles of compressedMultigrid without a new smallest residual after which the rounding stops them
+        size_t stagnationCycles = 4;
+
+        /// Threads and schedule of the OpenMP regions
+        ParallelOptions parallel;
+    };
+
+
+    namespace mgimpl {
+
+        /**
+         * Linear interpolation along one side between a fine and a coarse level.
+         * Both levels span the same plate: the borders lie on the positions 0 and
+         * n + 1 of each level, so the coarse pixels are uniformly spread but only
+         * lie on fine pixels when the fine side is odd.
+         *
+         * @tparam T    :   Data type
+         */
+        template<typename T>
+        struct Transfer {
+            /// Coarse pixel before each fine pixel
+            std::vector<size_t> cell;
+            /// Position of each fine pixel between cell and cell + 1, in [0, 1)
+            std::vector<T> fraction;
+            /// First and last fine pixel touching each coarse pixel
+            std::vector<size_t> first, last;
+            /// Inverse of the sum of the restriction weights of each coarse pixel
+            std::vector<T> norm;
+
+            /// Restriction weight of the fine pixel i on the coarse pixel I
+            inline T weight(const size_t i, const size_t I) const {
+                return (cell[i] == I) ? T(1) - fraction[i] : ((cell[i] + 1 == I) ? fraction[i] : T(0));
+            }
+        };
+
+
+        /**
+         * Builds the transfer between a side of fine inner pixels and a side
+         * of coarse inner pixels
+         *
+         * @tparam T            :   Data type
+         * @param fine          :   Number of inner pixels of the fine side
+         * @param coarse        :   Number of inner pixels of the coarse side
+         * @return              :   Interpolation and restriction data of the side
+         */
+        template<typename T>
+        Transfer<T> makeTransfer(const size_t fine, const size_t coarse) {
+
+            Transfer<T> t;
+            const T ratio = T(fine + 1) / T(coarse + 1);
+
+            t.cell.resize(fine + 2);
+            t.fraction.resize(fine + 2);
+            for (size_t i = 0; i < fine + 2; ++i) {
+                const T position = T(i) / ratio;
+                t.cell[i] = std::min(size_t(position), coarse);
+                t.fraction[i] = std::max(T(0), position - T(t.cell[i]));
+            }
+
+            t.first.assign(coarse + 2, 0);
+            t.last.assign(coarse + 2, 0);
+            t.norm.assign(coarse + 2, T(0));
+            std::fill(t.first.begin() + 1, t.first.end() - 1, fine + 1);
+
+            // Each fine pixel only weighs on the coarse pixels cell and cell + 1,
+            // and the cells grow with the fine pixels, so a single pass finds the
+            // support of every coarse pixel. The norm holds the sum of the
+            // weights until the end
+            for (size_t i = 1; i <= fine; ++i) {
+                for (size_t I = std::max(t.cell[i], size_t(1)); I <= std::min(t.cell[i] + 1, coarse); ++I) {
+                    const T w = t.weight(i, I);
+                    if (w > T(0)) {
+                        t.first[I] = std::min(t.first[I], i);
+                        t.last[I] = i;
+                        t.norm[I] += w;
+                    }
+                }
+            }
+
+            for (size_t I = 1; I <= coarse; ++I) {
+                t.norm[I] = (t.norm[I] > T(0)) ? T(1) / t.norm[I] : T(0);
+            }
+
+            return t;
+        }
+
+
+        /**
+         * Grid of one level of the hierarchy. The system solved on each level is
+         *
+         *   diagonal * u(i,j) - (up * u(i-1,j) + down * u(i+1,j) + left * u(i,j-1) + right * u(i,j+1)) = f(i,j)
+         *
+         * where the outer ring of u holds the border conditions (zero on the coarse levels).
+         * The grids may be stored in a 16 bit type, the level is operated in compute_t<T>.
+         */
+        template<typename T, class Alloc>
+        struct Level {
+            /// Approximation of the solution, borders included
+            anpi::Matrix<T, Alloc> u;
+            /// Right hand side, same size as u
+            anpi::Matrix<T, Alloc> f;
+            /// Residual and auxiliary grid of the Jacobi smoother, same size as u
+            anpi::Matrix<T, Alloc> r;
+            /// Weights of the neighbours
+            StencilWeights<compute_t<T> > weights;
+            /// Weight of the pixel itself
+            compute_t<T> diagonal;
+            /// The right hand side is zero and the diagonal one, as on the finest level
+            bool homogeneous = false;
+            /// Transfer between the rows of this level and the rows of the finer one
+            Transfer<compute_t<T> > rowTransfer;
+            /// Transfer between the columns of this level and the columns of the finer one
+            Transfer<compute_t<T> > colTransfer;
+        };
+
+
+        /**
+         * Weights of a level whose pixels are rowSpacing x colSpacing finest pixels.
+         * The inner operator is a scaled Laplacian, so the weights of a direction fall
+         * with the square of the spacing. A direction with just one isolated border
+         * behaves like a first derivative, so its weights only fall with the spacing.
+         *
+         * @tparam T            :   Data type
+         * @param finest        :   Weights of the finest level
+         * @param isIsolated    :   Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+         * @param rowSpacing    :   Vertical distance between pixels of the level
+         * @param colSpacing    :   Horizontal distance between pixels of the level
+         * @return              :   Weights of the level
+         */
+        template<typename T>
+        StencilWeights<T> levelWeights(const StencilWeights<T> &finest,
+                                       const std::vector<bool> &isIsolated,
+                                       const T rowSpacing,
+                                       const T colSpacing) {
+
+            const T vertical = (isIsolated.at(0) != isIsolated.at(1)) ? rowSpacing : rowSpacing * rowSpacing;
+            const T horizontal = (isIsolated.at(2) != isIsolated.at(3)) ? colSpacing : colSpacing * colSpacing;
+
+            return StencilWeights<T>{finest.up / vertical,
+                                     finest.down / vertical,
+                                     finest.left / horizontal,
+                                     finest.right / horizontal};
+        }
+
+
+        /**
+         * Smoothing sweeps on a level
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param level     : Level to smooth
+         * @param sweeps    : Number of sweeps
+         * @param options   : Smoother and threading options
+         */
+        template<typename T, class Alloc>
+        void smooth(Level<T, Alloc> &level,
+                    const size_t sweeps,
+                    const MultigridOptions &options) {
+
+            typedef compute_t<T> C;
+
+            const size_t rows = level.u.rows();
+            const size_t cols = level.u.cols();
+            const StencilWeights<C> w = level.weights;
+            const C invDiagonal = C(1) / level.diagonal;
+            const int threads = options.parallel.threadsFor(rows * cols, rows - 2);
+
+            // Without right hand side the weighted Jacobi sweep is the relaxed
+            // stencil of Liebmann, made by its SIMD kernels
+            if (level.homogeneous && options.smoother == MultigridSmoother::Jacobi) {
+                for (size_t s = 0; s < sweeps; ++s) {
+                    jacobiSweep(level.r, level.u, w, C(options.jacobiWeight), false, options.parallel);
+                    level.u.swap(level.r);
+                }
+                return;
+            }
+
+            for (size_t s = 0; s < sweeps; ++s) {
+
+                if (options.smoother == MultigridSmoother::RedBlackGaussSeidel) {
+
+                    for (size_t color = 0; color < 2; ++color) {
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+                        for (size_t i = 1; i < rows - 1; ++i) {
+
+                            T *row = level.u[i];
+                            const T *up = level.u[i - 1];
+                            const T *down = level.u[i + 1];
+                            const T *f = level.f[i];
+
+                            for (size_t j = 1 + ((i + 1 + color) & 1); j < cols - 1; j += 2) {
+                                row[j] = (C(f[j]) + w.up * C(up[j]) + w.down * C(down[j]) +
+                                          w.left * C(row[j - 1]) + w.right * C(row[j + 1])) * invDiagonal;
+                            }
+                        }
+                    }
+
+                } else {
+
+                    const C omega = C(options.jacobiWeight);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+                    for (size_t i = 1; i < rows - 1; ++i) {
+
+                        const T *row = level.u[i];
+                        const T *up = level.u[i - 1];
+                        const T *down = level.u[i + 1];
+                        const T *f = level.f[i];
+                        T *next = level.r[i];
+
+                        for (size_t j = 1; j < cols - 1; ++j) {
+                            const C jacobi = (C(f[j]) + w.up * C(up[j]) + w.down * C(down[j]) +
+                                              w.left * C(row[j - 1]) + w.right * C(row[j + 1])) * invDiagonal;
+                            next[j] = C(row[j]) + omega * (jacobi - C(row[j]));
+                        }
+                    }
+
+                    // Both grids share the same border ring, so swapping them is enough
+                    level.u.swap(level.r);
+                }
+            }
+        }
+
+
+        /**
+         * Computes the residual r = f - A u of the level
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param level     : Level whose residual is written in level.r
+         * @param options   : Threading options
+         * @return          : Largest absolute residual of a pixel
+         */
+        template<typename T, class Alloc>
+        compute_t<T> residual(Level<T, Alloc> &level,
+                              const MultigridOptions &options) {
+
+            typedef compute_t<T> C;
+
+            const size_t rows = level.u.rows();
+            const size_t cols = level.u.cols();
+            const StencilWeights<C> w = level.weights;
+            const C diagonal = level.diagonal;
+            const int threads = options.parallel.threadsFor(rows * cols, rows - 2);
+            C maxResidual = C(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) reduction(max : maxResidual)
+#endif
+            for (size_t i = 1; i < rows - 1; ++i) {
+
+                const T *row = level.u[i];
+                const T *up = level.u[i - 1];
+                const T *down = level.u[i + 1];
+                const T *f = level.f[i];
+                T *r = level.r[i];
+
+                for (size_t j = 1; j < cols - 1; ++j) {
+                    const C value = C(f[j]) + w.up * C(up[j]) + w.down * C(down[j]) +
+                                    w.left * C(row[j - 1]) + w.right * C(row[j + 1]) - diagonal * C(row[j]);
+                    r[j] = value;
+                    maxResidual = std::max(maxResidual, C(std::abs(value)));
+                }
+            }
+
+            return maxResidual;
+        }
+
+
+        /**
+         * Restriction of the fine residual into the right hand side of the coarse
+         * level, it is the transpose of the interpolation normalized to keep the
+         * average of the residual
+         *
+         * @tparam T        : Data type of the fine level
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @tparam U        : Data type of the coarse level
+         * @tparam UAlloc   : Allocator of the coarse level
+         * @param fine      : Level holding the residual in fine.r
+         * @param coarse    : Level whose right hand side is written
+         * @param options   : Threading options
+         */
+        template<typename T, class Alloc, typename U, class UAlloc>
+        void restrictResidual(const Level<T, Alloc> &fine,
+                              Level<U, UAlloc> &coarse,
+                              const MultigridOptions &options) {
+
+            typedef compute_t<U> C;
+
+            const size_t rows = coarse.f.rows();
+            const size_t cols = coarse.f.cols();
+            const Transfer<C> &rt = coarse.rowTransfer;
+            const Transfer<C> &ct = coarse.colTransfer;
+            const int threads = options.parallel.threadsFor(fine.r.rows() * fine.r.cols(), rows - 2);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+            for (size_t I = 1; I < rows - 1; ++I) {
+                for (size_t J = 1; J < cols - 1; ++J) {
+
+                    C sum = C(0);
+                    for (size_t i = rt.first[I]; i <= rt.last[I]; ++i) {
+
+                        const C wi = rt.weight(i, I);
+                        const T *r = fine.r[i];
+
+                        for (size_t j = ct.first[J]; j <= ct.last[J]; ++j) {
+                            sum += wi * ct.weight(j, J) * C(r[j]);
+                        }
+                    }
+
+                    coarse.f(I, J) = sum * rt.norm[I] * ct.norm[J];
+                }
+            }
+        }
+
+
+        /**
+         * Bilinear interpolation of the coarse correction, added to the fine approximation
+         *
+         * @tparam U        : Data type of the coarse level
+         * @tparam UAlloc   : Allocator of the coarse level
+         * @tparam T        : Data type of the fine level
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param coarse    : Level holding the correction in coarse.u
+         * @param fine      : Level whose approximation is corrected
+         * @param options   : Threading options
+         */
+        template<typename U, class UAlloc, typename T, class Alloc>
+        void prolongate(const Level<U, UAlloc> &coarse,
+                        Level<T, Alloc> &fine,
+                        const MultigridOptions &options) {
+
+            typedef compute_t<U> C;
+
+            const size_t rows = fine.u.rows();
+            const size_t cols = fine.u.cols();
+            const anpi::Matrix<U, UAlloc> &e = coarse.u;
+            const Transfer<C> &rt = coarse.rowTransfer;
+            const Transfer<C> &ct = coarse.colTransfer;
+            const int threads = options.parallel.threadsFor(rows * cols, rows - 2);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+            for (size_t i = 1; i < rows - 1; ++i) {
+
+                const U *e0 = e[rt.cell[i]];
+                const U *e1 = e[rt.cell[i] + 1];
+                const C s = rt.fraction[i];
+                T *row = fine.u[i];
+
+                for (size_t j = 1; j < cols - 1; ++j) {
+
+                    const size_t J = ct.cell[j];
+                    const C t = ct.fraction[j];
+
+                    row[j] = compute_t<T>(row[j]) +
+                             compute_t<T>((C(1) - s) * ((C(1) - t) * C(e0[J]) + t * C(e0[J + 1])) +
+                                          s * ((C(1) - t) * C(e1[J]) + t * C(e1[J + 1])));
+                }
+            }
+        }
+
+
+        /**
+         * Solves the level exactly with a banded Gaussian elimination. The pixels
+         * are numbered along the shortest dimension, so the bandwidth is the
+         * smallest side of the grid. The system is diagonally dominant, hence
+         * no pivoting is needed.
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param level     : Level to solve, its border ring is taken into account
+         */
+        template<typename T, class Alloc>
+        void directSolve(Level<T, Alloc> &level) {
+
+            const size_t m = level.u.rows() - 2;
+            const size_t n = level.u.cols() - 2;
+            const bool byRows = n <= m;
+            const size_t band = byRows ? n : m;
+            const size_t unknowns = m * n;
+
+            typedef compute_t<T> C;
+            const StencilWeights<C> w = level.weights;
+
+            // Position of the inner pixel (i,j) in the system, 0 based
+            auto index = [&](const size_t i, const size_t j) -> size_t {
+                return byRows ? i * n + j : j * m + i;
+            };
+
+            anpi::Matrix<C> A(unknowns, 2 * band + 1, C(0));
+            std::vector<C> b(unknowns);
+
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+
+                    const size_t k = index(i, j);
+                    A(k, band) = level.diagonal;
+                    b[k] = C(level.f(i + 1, j + 1));
+
+                    // Neighbours on the border ring go to the right hand side
+                    if (i > 0) A(k, band + index(i - 1, j) - k) = -w.up;
+                    else b[k] += w.up * C(level.u(0, j + 1));
+
+                    if (i + 1 < m) A(k, band + index(i + 1, j) - k) = -w.down;
+                    else b[k] += w.down * C(level.u(m + 1, j + 1));
+
+                    if (j > 0) A(k, band + index(i, j - 1) - k) = -w.left;
+                    else b[k] += w.left * C(level.u(i + 1, 0));
+
+                    if (j + 1 < n) A(k, band + index(i, j + 1) - k) = -w.right;
+                    else b[k] += w.right * C(level.u(i + 1, n + 1));
+                }
+            }
+
+            // Forward elimination inside the band
+            for (size_t k = 0; k < unknowns; ++k) {
+
+                const size_t last = std::min(k + band, unknowns - 1);
+
+                for (size_t r = k + 1; r <= last; ++r) {
+
+                    const C factor = A(r, band + k - r) / A(k, band);
+                    if (factor == C(0)) continue;
+
+                    for (size_t c = k; c <= last; ++c) {
+                        A(r, band + c - r) -= factor * A(k, band + c - k);
+                    }
+                    b[r] -= factor * b[k];
+                }
+            }
+
+            // Back substitution
+            for (size_t k = unknowns; k-- > 0;) {
+
+                const size_t last = std::min(k + band, unknowns - 1);
+                C sum = b[k];
+
+                for (size_t c = k + 1; c <= last; ++c) {
+                    sum -= A(k, band + c - k) * b[c];
+                }
+                b[k] = sum / A(k, band);
+            }
+
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    level.u(i + 1, j + 1) = b[index(i, j)];
+                }
+            }
+        }
+
+
+        /**
+         * Appends to levels the coarser levels of the hierarchy below the
+         * finest one, halving the sides while both have at least 3 inner
+         * pixels and more than options.coarsestUnknowns pixels are left
+         *
+         * @tparam T            : Data type of the finest level
+         * @tparam Alloc        : Allocator used for row allignment in the matrix values
+         * @tparam U            : Data type of the coarser levels
+         * @tparam UAlloc       : Allocator of the coarser levels
+         * @param finest        : Finest level, with its plate and weights set
+         * @param isIsolated    : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+         * @param options       : Multigrid options
+         * @param levels        : Hierarchy where the coarser levels are appended
+         */
+        template<typename T, class Alloc, typename U, class UAlloc>
+        void coarsen(const Level<T, Alloc> &finest,
+                     const std::vector<bool> &isIsolated,
+                     const MultigridOptions &options,
+                     std::vector<Level<U, UAlloc> > &levels) {
+
+            typedef compute_t<U> C;
+
+            // The finest level may be an entry of levels, so nothing of it
+            // is read once the levels start to be appended
+            const StencilWeights<C> weights{C(finest.weights.up), C(finest.weights.down),
+                                            C(finest.weights.left), C(finest.weights.right)};
+            size_t m = finest.u.rows() - 2;
+            size_t n = finest.u.cols() - 2;
+
+            // Distance between the pixels of the current level, in finest pixels
+            C rowSpacing = C(1);
+            C colSpacing = C(1);
+
+            while (m * n > options.coarsestUnknowns && m >= 3 && n >= 3) {
+
+                const size_t mc = m / 2;
+                const size_t nc = n / 2;
+                rowSpacing *= C(m + 1) / C(mc + 1);
+                colSpacing *= C(n + 1) / C(nc + 1);
+
+                Level<U, UAlloc> coarse;
+                coarse.u = anpi::Matrix<U, UAlloc>(mc + 2, nc + 2, U(0));
+                coarse.f = coarse.u;
+                coarse.r = coarse.u;
+                coarse.weights = levelWeights(weights, isIsolated, rowSpacing, colSpacing);
+                coarse.diagonal = coarse.weights.up + coarse.weights.down + coarse.weights.left + coarse.weights.right;
+                coarse.rowTransfer = makeTransfer<C>(m, mc);
+                coarse.colTransfer = makeTransfer<C>(n, nc);
+
+                levels.push_back(std::move(coarse));
+                m = mc;
+                n = nc;
+            }
+        }
+
+
+        /**
+         * Runs one cycle starting at the given level. The coarser levels may
+         * be of another data type than the current one, so the finest level of
+         * a plate stored in 16 bits is corrected by levels stored in float.
+         *
+         * @tparam T        : Data type of the current level
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @tparam U        : Data type of the coarser levels
+         * @tparam UAlloc   : Allocator of the coarser levels
+         * @param fine      : Current level
+         * @param levels    : Grid hierarchy, the last one is the coarsest
+         * @param l         : Position in levels of the level below the current one
+         * @param options   : Multigrid options
+         */
+        template<typename T, class Alloc, typename U, class UAlloc>
+        void cycle(Level<T, Alloc> &fine,
+                   std::vector<Level<U, UAlloc> > &levels,
+                   const size_t l,
+                   const MultigridOptions &options) {
+
+            if (l == levels.size()) {
+                directSolve(fine);
+                return;
+            }
+
+            Level<U, UAlloc> &coarse = levels[l];
+
+            const size_t corrections = (options.cycle == MultigridCycle::W) ? 2 : 1;
+
+            for (size_t c = 0; c < corrections; ++c) {
+                smooth(fine, options.preSmoothing, options);
+                residual(fine, options);
+                restrictResidual(fine, coarse, options);
+
+                // The correction starts from zero
+                coarse.u.fill(U(0));
+                cycle(coarse, levels, l + 1, options);
+
+                prolongate(coarse, fine, options);
+                smooth(fine, options.postSmoothing, options);
+            }
+        }
+
+    } // namespace mgimpl
+
+
+    /**
+     * Solves the plate with geometric multigrid cycles, starting from the current
+     * state of operationMatrix. The pixels use the same stencil and isolation rules
+     * of the pixel by pixel phase of liebmannAux.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param operationMatrix   : Plate with its borders set, the solution is written here
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param options           : Multigrid options
+     * @return                  : Number of cycles needed to converge
+     */
+    template<typename T, class Alloc>
+    size_t multigridAux(anpi::Matrix<T, Alloc> &operationMatrix,
+                        const std::vector<bool> &isIsolated,
+                        const MultigridOptions &options = MultigridOptions()) {
+
+        // Every level halves the sides, so the hierarchy is never deeper than this
+        std::vector<mgimpl::Level<T, Alloc> > levels(1);
+        levels.reserve(64);
+
+        // The finest level works directly on the plate
+        levels[0].u = std::move(operationMatrix);
+        levels[0].f = anpi::Matrix<T, Alloc>(levels[0].u.rows(), levels[0].u.cols(), T(0));
+        levels[0].r = levels[0].u;
+        levels[0].weights = isolationWeights<T>(isIsolated);
+        levels[0].diagonal = T(1);
+        levels[0].homogeneous = true;
+
+        mgimpl::coarsen(levels[0], isIsolated, options, levels);
+
+        size_t cycles = 0;
+        while (cycles < options.maxCycles &&
+               mgimpl::residual(levels[0], options) > T(options.tolerance)) {
+            mgimpl::cycle(levels[0], levels, 1, options);
+            ++cycles;
+        }
+
+        operationMatrix = std::move(levels[0].u);
+
+        return cycles;
+    }
+
+
+    /**
+     * Master function of the multigrid solver, it has the same frontier conditions
+     * of anpi::liebmann and returns the heat distribution of the plate
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param options           : Multigrid options
+     * @return                  : A matrix with the heat distribution given the border conditions
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, Alloc> multigrid(anpi::Matrix<T, Alloc> &frontierConditions,
+                                     const size_t verticalLength,
+                                     const size_t horizontalLength,
+                                     const std::vector<bool> &isIsolated,
+                                     const MultigridOptions &options = MultigridOptions()) {
+
+        anpi::Matrix<T, Alloc> operationMatrix = initializePlate(frontierConditions,
+                                                                 verticalLength,
+                                                                 horizontalLength,
+                                                                 isIsolated);
+
+        multigridAux(operationMatrix, isIsolated, options);
+
+        return operationMatrix;
+    }
+
+
+    /**
+     * Multigrid on a plate stored in a 16 bit type S, bfloat16 or half, with
+     * the coarser levels stored in compute_t<S>. The finest level takes half
+     * the memory of float, and the coarser levels add a third of a float
+     * plate for each of their three grids. With the Jacobi smoother the
+     * finest level is smoothed by the SIMD kernels of Liebmann, which widen
+     * the pixels when they are loaded and round them when they are stored.
+     *
+     * The rounding of S bounds the accuracy: the residual of a plate rounded
+     * to S stops falling around the spacing of S, so besides options.tolerance
+     * the cycles stop once options.stagnationCycles of them pass without a new
+     * smallest residual. bfloat16 keeps less than three significant digits and
+     * half about three, up to 65504.
+     *
+     * @tparam S                : Storage type of the finest level
+     * @tparam T                : Data type of the frontier conditions and of the coarser levels, compute_t<S>
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param options           : Multigrid options
+     * @return                  : A matrix of S with the heat distribution given the border conditions
+     */
+    template<typename S, typename T, class Alloc>
+    anpi::Matrix<S, typename Alloc::template rebind<S>::other>
+    compressedMultigrid(anpi::Matrix<T, Alloc> &frontierConditions,
+                        const size_t verticalLength,
+                        const size_t horizontalLength,
+                        const std::vector<bool> &isIsolated,
+                        const MultigridOptions &options = MultigridOptions()) {
+
+        static_assert(std::is_same<compute_t<S>, T>::value,
+                      "The frontier conditions must be given in the compute type of the storage");
+
+        typedef typename Alloc::template rebind<S>::other SAlloc;
+
+        mgimpl::Level<S, SAlloc> finest;
+        initializePlate(frontierConditions, verticalLength, horizontalLength, isIsolated, finest.u);
+        finest.f = anpi::Matrix<S, SAlloc>(finest.u.rows(), finest.u.cols(), S(0));
+        finest.r = finest.u;
+        finest.weights = isolationWeights<T>(isIsolated);
+        finest.diagonal = T(1);
+        finest.homogeneous = true;
+
+        std::vector<mgimpl::Level<T, Alloc> > levels;
+        levels.reserve(64);
+        mgimpl::coarsen(finest, isIsolated, options, levels);
+
+        // The residual is not monotone, so the cycles stop once a few of
+        // them pass without a new smallest residual
+        T smallest = std::numeric_limits<T>::max();
+        size_t sinceSmallest = 0;
+
+        for (size_t cycles = 0; cycles < options.maxCycles; ++cycles) {
+            const T residual = mgimpl::residual(finest, options);
+
+            if (residual <= T(options.tolerance)) {
+                break;
+            }
+            if (residual < smallest) {
+                smallest = residual;
+                sinceSmallest = 0;
+            } else if (++sinceSmallest == options.stagnationCycles) {
+                break;
+            }
+
+            mgimpl::cycle(finest, levels, 0, options);
+        }
+
+        return std::move(finest.u);
+    }
+
+
+} //namespace anpi
+
+
+
+#endif //ANPI_MULTIGRID_H
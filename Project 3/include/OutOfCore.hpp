@@ -0,0 +1,371 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_OUT_OF_CORE_H
+#define ANPI_OUT_OF_CORE_H
+
+
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+#include "Exception.hpp"
+#include "Liebmann.hpp"
+#include "Multigrid.hpp"
+#include "ParallelOptions.hpp"
+
+namespace anpi {
+
+    /**
+     * Parameters of the Liebmann method on a plate mapped from a file
+     */
+    struct StreamingOptions {
+        /// Rows read ahead of the sweeps, and released behind them, at a time
+        size_t bandRows = 64;
+
+        /// Red-black SOR sweeps made on each pass over the file
+        size_t sweepsPerPass = 16;
+
+        /// Largest change of a pixel on the last sweep of a pass accepted as converged
+        double tolerance = 1e-4;
+
+        /// Maximum number of passes over the file
+        size_t maxPasses = 100000;
+
+        /// Largest number of pixels of the multigrid solve in memory used as initial guess, 0 starts from the average
+        size_t coarsePixels = size_t(1) << 22;
+
+        /// If not null, receives the change of the last sweep of every pass
+        std::vector<double> *residualHistory = nullptr;
+
+        /// Threads and schedule of the OpenMP regions
+        ParallelOptions parallel;
+    };
+
+
+    namespace oocimpl {
+
+        /// Rows between the pixels updated by two consecutive sweeps of a pass
+        constexpr size_t lag = 3;
+
+
+        /**
+         * Linear interpolation of a line of frontier conditions to another
+         * number of pixels. Both lines span the same border: their ends lie
+         * on the positions -1 and n of each line.
+         *
+         * @tparam T        : Data type
+         * @tparam Alloc    : Allocator used for row allignment in the matrix values
+         * @param frontier  : Frontier conditions. Convention used: {top; bot; left; right}
+         * @param line      : Line of the frontier conditions
+         * @param length    : Pixels of the line
+         * @param target    : Pixels of the result
+         * @return          : Interpolated line
+         */
+        template<typename T, class Alloc>
+        std::vector<T> resampleLine(const anpi::Matrix<T, Alloc> &frontier,
+                                    const size_t line,
+                                    const size_t length,
+                                    const size_t target) {
+
+            std::vector<T> result(target);
+            const T *values = frontier[line];
+            const T scale = T(length + 1) / T(target + 1);
+
+            for (size_t k = 0; k < target; ++k) {
+                const T position = std::min(std::max(T(k + 1) * scale - T(1), T(0)), T(length - 1));
+                const size_t cell = std::min(size_t(position), length > 1 ? length - 2 : 0);
+                const T fraction = (length > 1) ? position - T(cell) : T(0);
+                result[k] = values[cell] + fraction * (values[std::min(cell + 1, length - 1)] - values[cell]);
+            }
+
+            return result;
+        }
+
+
+        /**
+         * Writes the initial state of the plate one row at a time: the
+         * frontier conditions on the borders and, inside, the bilinear
+         * interpolation of a coarse solution of the plate, or the average of
+         * the borders without one. The rows written are released as it goes.
+         *
+         * @tparam T                : Data type
+         * @tparam Alloc            : Allocator used for row allignment in the matrix values
+         * @tparam Align            : Alignment of the rows of the plate
+         * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+         * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+         * @param coarse            : Coarse solution of the plate, borders included, empty for none
+         * @param plate             : Mapped plate, already allocated
+         * @param allocator         : Allocator that mapped the plate
+         */
+        template<typename T, class Alloc, size_t Align>
+        void writeInitialPlate(anpi::Matrix<T, Alloc> &frontierConditions,
+                               const std::vector<bool> &isIsolated,
+                               const anpi::Matrix<T> &coarse,
+                               anpi::Matrix<T, mmap_allocator<T, Align> > &plate,
+                               const mmap_allocator<T, Align> &allocator) {
+
+            const size_t rows = plate.rows();
+            const size_t cols = plate.cols();
+            const T average = averageFrontier(frontierConditions, rows - 2, cols - 2, isIsolated);
+
+            // Source position of each column, reused by every row
+            std::vector<size_t> colCell(cols, 0);
+            std::vector<T> colFraction(cols, T(0));
+            if (!coarse.empty()) {
+                const T colScale = T(coarse.cols() - 1) / T(cols - 1);
+                for (size_t j = 0; j < cols; ++j) {
+                    const T position = T(j) * colScale;
+                    colCell[j] = std::min(size_t(position), coarse.cols() - 2);
+                    colFraction[j] = position - T(colCell[j]);
+                }
+            }
+
+            for (size_t i = 0; i < rows; ++i) {
+                T *row = plate[i];
+
+                if (i == 0 || i == rows - 1) {
+                    const T *border = frontierConditions[i == 0 ? 0 : 1];
+                    row[0] = average;
+                    std::copy(border, border + (cols - 2), row + 1);
+                    row[cols - 1] = average;
+                } else {
+                    if (coarse.empty()) {
+                        std::fill(row + 1, row + cols - 1, average);
+                    } else {
+                        const T position = T(i) * T(coarse.rows() - 1) / T(rows - 1);
+                        const size_t cell = std::min(size_t(position), coarse.rows() - 2);
+                        const T fraction = position - T(cell);
+                        const T *up = coarse[cell];
+                        const T *down = coarse[cell + 1];
+
+                        for (size_t j = 1; j < cols - 1; ++j) {
+                            const size_t c = colCell[j];
+                            const T f = colFraction[j];
+                            const T top = up[c] + f * (up[c + 1] - up[c]);
+                            const T bottom = down[c] + f * (down[c + 1] - down[c]);
+                            row[j] = top + fraction * (bottom - top);
+                        }
+                    }
+                    row[0] = frontierConditions(2, i - 1);
+                    row[cols - 1] = frontierConditions(3, i - 1);
+                }
+
+                allocator.release(row, plate.dcols());
+            }
+        }
+
+    } // namespace oocimpl
+
+
+    /**
+     * One pass of red-black SOR sweeps over a mapped plate. The sweeps are
+     * pipelined over the rows: each sweep follows the previous one three
+     * rows behind, so the rows are read once per pass and only a window of
+     * about 3 * sweeps rows is in use. The rows of one sweep are updated in
+     * the same order as by redBlackSweep, so the pass gives the same plate
+     * as that many calls to it, and the sweeps of a window are independent
+     * from each other, so they run on different threads.
+     *
+     * The rows ahead of the window are prefetched and the ones behind it
+     * are released a band at a time, so the reads and writes of the file
+     * are sequential.
+     *
+     * @tparam T            : Data type
+     * @tparam Align        : Alignment of the rows of the plate
+     * @param plate         : Mapped plate, updated in place
+     * @param allocator     : Allocator that mapped the plate
+     * @param weights       : Stencil weights given by the isolation of the borders
+     * @param omega         : Relaxation factor
+     * @param sweeps        : Sweeps made on the pass
+     * @param bandRows      : Rows prefetched and released at a time
+     * @param parallel      : Threads and schedule of the OpenMP regions
+     * @return              : Norms of the change of the pixels on the last sweep
+     */
+    template<typename T, size_t Align>
+    UpdateNorms<T> streamingPass(anpi::Matrix<T, mmap_allocator<T, Align> > &plate,
+                                 const mmap_allocator<T, Align> &allocator,
+                                 const StencilWeights<T> &weights,
+                                 const T omega,
+                                 const size_t sweeps,
+                                 const size_t bandRows,
+                                 const ParallelOptions &parallel = ParallelOptions()) {
+
+        const size_t rows = plate.rows();
+        const size_t cols = plate.cols();
+        const size_t band = std::max(bandRows, size_t(1));
+        const int threads = parallel.threadsFor(rows * cols, sweeps);
+
+        // The stage r updates the red pixels of the row r - lag * s and the
+        // black pixels of the row above it for each sweep s. The last sweep
+        // still reads depth rows behind the stage
+        const size_t stages = rows - 1 + oocimpl::lag * (sweeps - 1);
+        const size_t depth = oocimpl::lag * (sweeps - 1) + 2;
+        size_t released = 0;
+
+        T maxUpdate = T(0);
+        T squares = T(0);
+
+        dispatchIsolation(isolationPattern(weights), [&](auto pattern) {
+            constexpr unsigned Pattern = decltype(pattern)::value;
+
+            for (size_t r = 1; r <= stages; ++r) {
+
+                if ((r - 1) % band == 0) {
+                    const size_t first = std::min(r, rows);
+                    const size_t last = std::min(r + 2 * band, rows);
+                    allocator.prefetch(plate[first], (last - first) * plate.dcols());
+
+                    if (r > depth + 1) {
+                        allocator.release(plate[released], (r - depth - 1 - released) * plate.dcols());
+                        released = r - depth - 1;
+                    }
+                }
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1) \
+        reduction(max : maxUpdate) reduction(+ : squares)
+#endif
+                for (size_t s = 0; s < sweeps; ++s) {
+                    if (r < oocimpl::lag * s + 1) {
+                        continue;
+                    }
+
+                    const size_t i = r - oocimpl::lag * s;
+                    UpdateNorms<T> norms;
+
+                    if (i < rows - 1) {
+                        norms = ::anpi::aimpl::redBlackRow<Pattern>(plate, i, 0, weights, omega);
+                    }
+                    if (i > 1 && i <= rows - 1) {
+                        const UpdateNorms<T> black =
+                                ::anpi::aimpl::redBlackRow<Pattern>(plate, i - 1, 1, weights, omega);
+                        norms.max = std::max(norms.max, black.max);
+                        norms.squares += black.squares;
+                    }
+
+                    if (s + 1 == sweeps) {
+                        maxUpdate = std::max(maxUpdate, norms.max);
+                        squares += norms.squares;
+                    }
+                }
+            }
+        });
+
+        allocator.release(plate[released], (rows - released) * plate.dcols());
+
+        UpdateNorms<T> norms;
+        norms.max = maxUpdate;
+        norms.squares = squares;
+        norms.count = (rows - 2) * (cols - 2);
+
+        return norms;
+    }
+
+
+    /**
+     * Liebmann method on a plate that lives in a file, for plates larger
+     * than the memory. The plate is a matrix mapped by mmap_allocator and is
+     * swept in passes of options.sweepsPerPass red-black SOR sweeps, see
+     * streamingPass, until the change of the last sweep of a pass is within
+     * options.tolerance. Only the window of rows of a pass, the bands read
+     * ahead of it and the frontier conditions are resident.
+     *
+     * SOR from the average of the borders needs a number of sweeps in the
+     * order of the side of the plate, too many passes over a file for a
+     * large plate. The initial guess is instead the bilinear interpolation
+     * of a multigrid solution in memory of at most options.coarsePixels
+     * pixels, so the passes only remove the difference between both
+     * resolutions.
+     *
+     * @tparam T                : Data type
+     * @tparam Alloc            : Allocator used for row allignment in the matrix values
+     * @param path              : File of the plate, created or overwritten
+     * @param frontierConditions: Sets the state of the borders of the plate. Convention used: {top; bot; left; right}
+     * @param verticalLength    : Number of rows in the operation matrix
+     * @param horizontalLength  : Number of columns in the operation matrix
+     * @param isIsolated        : Vector describing if a border is isolated. Convention used: {top; bot; left; right}
+     * @param options           : Window, convergence and initial guess parameters
+     * @return                  : A matrix mapped from the file with the heat distribution
+     */
+    template<typename T, class Alloc>
+    anpi::Matrix<T, mmap_allocator<T> > streamingLiebmann(const std::string &path,
+                                                          anpi::Matrix<T, Alloc> &frontierConditions,
+                                                          const size_t verticalLength,
+                                                          const size_t horizontalLength,
+                                                          const std::vector<bool> &isIsolated,
+                                                          const StreamingOptions &options = StreamingOptions()) {
+
+        if (verticalLength == 0 || horizontalLength == 0 ||
+            frontierConditions.rows() < 4 ||
+            frontierConditions.cols() < std::max(verticalLength, horizontalLength)) {
+            throw anpi::Exception("Las condiciones de frontera no cubren la placa");
+        }
+
+        // Coarse solution in memory, of the same proportions as the plate
+        anpi::Matrix<T> coarse;
+        if (options.coarsePixels > 0) {
+            const double factor = std::max(1.0, std::sqrt(double(verticalLength) * double(horizontalLength) /
+                                                          double(options.coarsePixels)));
+            const size_t coarseRows = std::max(size_t(1), size_t(double(verticalLength) / factor));
+            const size_t coarseCols = std::max(size_t(1), size_t(double(horizontalLength) / factor));
+
+            anpi::Matrix<T> coarseFrontier(4, std::max(coarseRows, coarseCols), T(0));
+            const std::vector<T> lines[4] = {
+                    oocimpl::resampleLine(frontierConditions, 0, horizontalLength, coarseCols),
+                    oocimpl::resampleLine(frontierConditions, 1, horizontalLength, coarseCols),
+                    oocimpl::resampleLine(frontierConditions, 2, verticalLength, coarseRows),
+                    oocimpl::resampleLine(frontierConditions, 3, verticalLength, coarseRows)};
+            for (size_t k = 0; k < 4; ++k) {
+                std::copy(lines[k].begin(), lines[k].end(), coarseFrontier[k]);
+            }
+
+            MultigridOptions multigridOptions;
+            multigridOptions.parallel = options.parallel;
+            coarse = multigrid(coarseFrontier, coarseRows, coarseCols, isIsolated, multigridOptions);
+        }
+
+        mmap_allocator<T> allocator(path);
+        anpi::Matrix<T, mmap_allocator<T> > plate(verticalLength + 2, horizontalLength + 2,
+                                                  anpi::DoNotInitialize, allocator);
+
+        oocimpl::writeInitialPlate(frontierConditions, isIsolated, coarse, plate, allocator);
+
+        const StencilWeights<T> weights = isolationWeights<T>(isIsolated);
+        const T omega = optimalOmega<T>(plate.rows(), plate.cols(), isIsolated);
+        const size_t sweeps = std::max(options.sweepsPerPass, size_t(1));
+
+        if (options.residualHistory) {
+            options.residualHistory->clear();
+        }
+
+        for (size_t pass = 0; pass < options.maxPasses; ++pass) {
+            const UpdateNorms<T> norms = streamingPass(plate, allocator, weights, omega, sweeps,
+                                                       options.bandRows, options.parallel);
+
+            if (options.residualHistory) {
+                options.residualHistory->push_back(double(norms.max));
+            }
+            if (norms.max <= T(options.tolerance)) {
+                break;
+            }
+        }
+
+        return plate;
+    }
+
+
+} //namespace anpi
+
+
+#endif //ANPI_OUT_OF_CORE_H
@@ -0,0 +1,121 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_PARALLEL_OPTIONS_H
+#define ANPI_PARALLEL_OPTIONS_H
+
+
+#include <cstdlib>
+#include <algorithm>
+
+#include "AnpiConfig.hpp"
+
+#ifdef ANPI_ENABLE_OpenMP
+#include <omp.h>
+#endif
+
+namespace anpi {
+
+    /**
+     * Distribution of the iterations of a parallel loop among the threads
+     */
+    enum class ParallelSchedule {
+        /// Equal blocks assigned before the loop starts
+        Static,
+        /// Blocks taken by the threads as they finish the previous one
+        Dynamic,
+        /// Like Dynamic, with blocks that shrink as the loop advances
+        Guided
+    };
+
+
+    /**
+     * Parameters of the OpenMP regions of the solvers
+     */
+    struct ParallelOptions {
+        /// Flag to activate openMP
+        bool isUsingOpenMP = true;
+
+        /// Threads used on each region, 0 uses all the available ones
+        size_t threads = 0;
+
+        /// Schedule of the loops split among the threads
+        ParallelSchedule schedule = ParallelSchedule::Static;
+
+        /// Iterations given to a thread at once, 0 keeps the default of the schedule
+        size_t chunkSize = 0;
+
+        /// Regions over less pixels than this run serially, the threads cost more than they save
+        size_t serialThreshold = 16384;
+
+        /**
+         * Threads to use on a region. It also sets the schedule of the loops
+         * declared with schedule(runtime) through omp_set_schedule, which is
+         * a setting of the calling thread and not of these options: it must
+         * be called right before the region it is meant for, and it changes
+         * the schedule of any later runtime loop of the thread. Without
+         * ANPI_ENABLE_OpenMP, as for the pragmas, it always returns 1.
+         *
+         * @param pixels        :   Pixels processed by the region
+         * @param iterations    :   Iterations of the parallel loop, no more threads than these are used
+         * @return              :   Number of threads, 1 for a serial region
+         */
+        inline int threadsFor(const size_t pixels, const size_t iterations) const {
+#ifdef ANPI_ENABLE_OpenMP
+            if (!isUsingOpenMP || pixels < serialThreshold) {
+                return 1;
+            }
+
+            const size_t available = (threads > 0) ? threads : size_t(omp_get_max_threads());
+
+            switch (schedule) {
+                case ParallelSchedule::Dynamic:
+                    omp_set_schedule(omp_sched_dynamic, int(chunkSize));
+                    break;
+                case ParallelSchedule::Guided:
+                    omp_set_schedule(omp_sched_guided, int(chunkSize));
+                    break;
+                default:
+                    omp_set_schedule(omp_sched_static, int(chunkSize));
+                    break;
+            }
+
+            return int(std::max(size_t(1), std::min(available, iterations)));
+#else
+            return 1;
+#endif
+        }
+    };
+
+
+    /**
+     * Options of the element-wise matrix operations that are not given
+     * their own, like the arithmetic operators, fill and the reductions.
+     * They may be changed globally, e.g.
+     *
+     *   anpi::elementWiseParallel().threads = 8;
+     *
+     * but not while other threads run such operations. These operations
+     * are limited by the memory bandwidth, so matrices below a few
+     * hundreds of KiB, which are read from the caches, run serially.
+     */
+    inline ParallelOptions &elementWiseParallel() {
+        static ParallelOptions options = []() {
+            ParallelOptions defaults;
+            defaults.serialThreshold = 262144;
+            return defaults;
+        }();
+        return options;
+    }
+
+
+} //namespace anpi
+
+
+#endif //ANPI_PARALLEL_OPTIONS_H
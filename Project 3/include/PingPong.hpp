@@ -0,0 +1,87 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date  : 17.10.2026
+ */
+
+#ifndef ANPI_PINGPONG_H
+#define ANPI_PINGPONG_H
+
+
+#include <utility>
+
+#include "Matrix.hpp"
+
+namespace anpi {
+
+    /**
+     * Pair of preallocated grids for iterative methods that read the last
+     * iteration and write the next one. The front grid holds the newest state
+     * and the back grid is where the next state is written, after it is
+     * complete swap() exchanges them by pointer without copying any pixel.
+     *
+     * @tparam T        :   Data type
+     * @tparam Alloc    :   Allocator used for row allignment in the matrix values
+     */
+    template<typename T, class Alloc = anpi::aligned_row_allocator<T> >
+    class PingPong {
+    public:
+        /// Empty grids
+        PingPong() = default;
+
+        /// Both grids start with the given state
+        explicit PingPong(const anpi::Matrix<T, Alloc> &initial)
+                : _front(initial), _back(initial) {}
+
+        /// Both grids start with the given state, taking over its memory for the front grid
+        explicit PingPong(anpi::Matrix<T, Alloc> &&initial)
+                : _front(std::move(initial)), _back(_front) {}
+
+        /// Both grids start with the given state, taking over the memory of
+        /// both matrices, so a back grid of the same size is not reallocated
+        PingPong(anpi::Matrix<T, Alloc> &&initial, anpi::Matrix<T, Alloc> &&back)
+                : _front(std::move(initial)), _back(std::move(back)) {
+            _back = _front;
+        }
+
+        /// Newest complete state
+        inline anpi::Matrix<T, Alloc> &front() { return _front; }
+
+        /// Newest complete state
+        inline const anpi::Matrix<T, Alloc> &front() const { return _front; }
+
+        /// Grid where the next state is written
+        inline anpi::Matrix<T, Alloc> &back() { return _back; }
+
+        /// Grid where the next state is written
+        inline const anpi::Matrix<T, Alloc> &back() const { return _back; }
+
+        /// The state written on the back grid becomes the front one
+        inline void swap() { _front.swap(_back); }
+
+        /// Moves the newest state out, the grids are left empty
+        inline anpi::Matrix<T, Alloc> release() {
+            _back.clear();
+            return std::move(_front);
+        }
+
+        /// Moves the newest state out and the memory of the back grid into
+        /// back, so it can be reused, the grids are left empty
+        inline anpi::Matrix<T, Alloc> release(anpi::Matrix<T, Alloc> &back) {
+            back = std::move(_back);
+            return std::move(_front);
+        }
+
+    private:
+        anpi::Matrix<T, Alloc> _front;
+        anpi::Matrix<T, Alloc> _back;
+    };
+
+
+} //namespace anpi
+
+
+#endif //ANPI_PINGPONG_H
@@ -6,6 +6,7 @@
 #define PROYECTO2_INTRINSICSMETHODS_H
 
 #include "Intrinsics.hpp"
+#include "HalfPrecision.hpp"
 
 //-------------------------------------------- AVX only --------------------------------------------
 
@@ -33,6 +34,22 @@ regType mm_loadRegister(const T *);
 
 #endif
 
+#ifdef __AVX512F__
+
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_loadRegister<double>(const double *a) {
+        return _mm512_load_pd(a);
+    }
+
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_loadRegister<float>(const float *a) {
+        return _mm512_load_ps(a);
+    }
+
+#endif
+
 
 /**
  * Load method for unalligned registers
@@ -58,6 +75,22 @@ regType mm_loadRegisteru(const T *);
 
 #endif
 
+#ifdef __AVX512F__
+
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_loadRegisteru<double>(const double *a) {
+        return _mm512_loadu_pd(a);
+    }
+
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_loadRegisteru<float>(const float *a) {
+        return _mm512_loadu_ps(a);
+    }
+
+#endif
+
 
 /**
  * Implementation of substraction
@@ -133,6 +166,22 @@ regType mm_sub(regType, regType);
     }
 #endif
 
+#ifdef __AVX512F__
+
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_sub<double>(__m512d a, __m512d b) {
+        return _mm512_sub_pd(a, b);
+    }
+
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_sub<float>(__m512 a, __m512 b) {
+        return _mm512_sub_ps(a, b);
+    }
+
+#endif
+
 
 
 
@@ -214,6 +263,22 @@ regType mm_add(regType, regType);
 
 #endif
 
+#ifdef __AVX512F__
+
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_add<double>(__m512d a, __m512d b) {
+        return _mm512_add_pd(a, b);
+    }
+
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_add<float>(__m512 a, __m512 b) {
+        return _mm512_add_ps(a, b);
+    }
+
+#endif
+
 
 /**
  * Implementation of division
@@ -242,6 +307,22 @@ regType mm_div(regType, regType);
 
 #endif
 
+#ifdef __AVX512F__
+
+    template<>
+    inline __m512d __attribute__((__always_inline__))
+    mm_div<double>(__m512d a, __m512d b) {
+        return _mm512_div_pd(a, b);
+    }
+
+    template<>
+    inline __m512 __attribute__((__always_inline__))
+    mm_div<float>(__m512 a, __m512 b) {
+        return _mm512_div_ps(a, b);
+    }
+
+#endif
+
 
 
 /**
@@ -308,8 +389,609 @@ mm_mult<int16_t>(__m256i a, __m256i b) {
 
 #endif
 
+#ifdef __AVX512F__
+
+template<>
+inline __m512d __attribute__((__always_inline__))
+mm_mult<double>(__m512d a, __m512d b) {
+    return _mm512_mul_pd(a, b);
+}
+
+template<>
+inline __m512 __attribute__((__always_inline__))
+mm_mult<float>(__m512 a, __m512 b) {
+    return _mm512_mul_ps(a, b);
+}
+
+#endif
+
+
+
+/**
+ * Fused multiply-add, a * b + c. Without FMA support it is computed with
+ * a multiplication and an addition
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         First factor
+ * @param b         Second factor
+ * @param c         Register added to the product
+ * @return          Register with the result of the operation
+ */
+template<typename T, class regType>
+regType mm_fmadd(regType, regType, regType);
+
+#ifdef __AVX__
+
+template<>
+inline __m256d __attribute__((__always_inline__))
+mm_fmadd<double>(__m256d a, __m256d b, __m256d c) {
+#ifdef __FMA__
+    return _mm256_fmadd_pd(a, b, c);
+#else
+    return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_fmadd<float>(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+#endif
+
+#ifdef __AVX512F__
+
+template<>
+inline __m512d __attribute__((__always_inline__))
+mm_fmadd<double>(__m512d a, __m512d b, __m512d c) {
+    return _mm512_fmadd_pd(a, b, c);
+}
+
+template<>
+inline __m512 __attribute__((__always_inline__))
+mm_fmadd<float>(__m512 a, __m512 b, __m512 c) {
+    return _mm512_fmadd_ps(a, b, c);
+}
+
+#endif
+
+
+/**
+ * Implementation of the element wise maximum
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         First register to compare
+ * @param b         Second register to compare
+ * @return          Register with the largest value of each entry
+ */
+template<typename T, class regType>
+regType mm_max(regType, regType);
+
+#ifdef __AVX__
+
+template<>
+inline __m256d __attribute__((__always_inline__))
+mm_max<double>(__m256d a, __m256d b) {
+    return _mm256_max_pd(a, b);
+}
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_max<float>(__m256 a, __m256 b) {
+    return _mm256_max_ps(a, b);
+}
+
+#endif
+
+#ifdef __AVX512F__
+
+template<>
+inline __m512d __attribute__((__always_inline__))
+mm_max<double>(__m512d a, __m512d b) {
+    return _mm512_max_pd(a, b);
+}
+
+template<>
+inline __m512 __attribute__((__always_inline__))
+mm_max<float>(__m512 a, __m512 b) {
+    return _mm512_max_ps(a, b);
+}
+
+#endif
 
 
+/**
+ * Checks whether all the entries of a register are greater than or equal
+ * to the entries of another one. NaN entries fail the comparison
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         First register to compare
+ * @param b         Second register to compare
+ * @return          true if a >= b in all the entries
+ */
+template<typename T, class regType>
+bool mm_allGreaterEqual(regType, regType);
+
+#ifdef __AVX__
+
+template<>
+inline bool __attribute__((__always_inline__))
+mm_allGreaterEqual<double>(__m256d a, __m256d b) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ)) == 0xF;
+}
+
+template<>
+inline bool __attribute__((__always_inline__))
+mm_allGreaterEqual<float>(__m256 a, __m256 b) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ)) == 0xFF;
+}
+
+#endif
+
+#ifdef __AVX512F__
+
+template<>
+inline bool __attribute__((__always_inline__))
+mm_allGreaterEqual<double>(__m512d a, __m512d b) {
+    return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ) == 0xFF;
+}
+
+template<>
+inline bool __attribute__((__always_inline__))
+mm_allGreaterEqual<float>(__m512 a, __m512 b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ) == 0xFFFF;
+}
+
+#endif
+
+
+/**
+ * Copies a scalar into all the entries of a register
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         Value to be copied
+ * @return          Register with all its entries set to a
+ */
+template<typename T, class regType>
+regType mm_set1(T);
+
+#ifdef __AVX__
+
+template<>
+inline __m256d __attribute__((__always_inline__))
+mm_set1<double>(double a) {
+    return _mm256_set1_pd(a);
+}
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_set1<float>(float a) {
+    return _mm256_set1_ps(a);
+}
+
+#endif
+
+#ifdef __AVX512F__
+
+template<>
+inline __m512d __attribute__((__always_inline__))
+mm_set1<double>(double a) {
+    return _mm512_set1_pd(a);
+}
+
+template<>
+inline __m512 __attribute__((__always_inline__))
+mm_set1<float>(float a) {
+    return _mm512_set1_ps(a);
+}
+
+#endif
+
+
+
+/**
+ * Selects the entries of two registers with a mask
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         Entries taken where the mask is clear
+ * @param b         Entries taken where the mask is set
+ * @param mask      Register with all the bits of an entry set or clear
+ * @return          Register with the selected entries
+ */
+template<typename T, class regType>
+regType mm_blend(regType, regType, regType);
+
+#ifdef __AVX__
+
+template<>
+inline __m256d __attribute__((__always_inline__))
+mm_blend<double>(__m256d a, __m256d b, __m256d mask) {
+    return _mm256_blendv_pd(a, b, mask);
+}
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_blend<float>(__m256 a, __m256 b, __m256 mask) {
+    return _mm256_blendv_ps(a, b, mask);
+}
+
+#endif
+
+
+/**
+ * Load method for the entries of an alligned register selected by a mask,
+ * the other entries are zero and their memory is not read
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         Pointer to the data to be loaded
+ * @param mask      Register with all the bits of an entry set or clear
+ * @return          Register with the selected entries
+ */
+template<typename T, class regType>
+regType mm_maskLoadRegister(const T *, regType);
+
+#ifdef __AVX__
+
+template<>
+inline __m256d __attribute__((__always_inline__))
+mm_maskLoadRegister<double>(const double *a, __m256d mask) {
+    return _mm256_maskload_pd(a, _mm256_castpd_si256(mask));
+}
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_maskLoadRegister<float>(const float *a, __m256 mask) {
+    return _mm256_maskload_ps(a, _mm256_castps_si256(mask));
+}
+
+#endif
+
+
+/**
+ * Store method for the entries of an alligned register selected by a mask,
+ * the memory of the other entries is not written
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         Pointer to the destination of the register data
+ * @param mask      Register with all the bits of an entry set or clear
+ * @param b         Register to be stored
+ */
+template<typename T, class regType>
+void mm_maskStoreRegister(T *, regType, regType);
+
+#ifdef __AVX__
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_maskStoreRegister<double>(double *a, __m256d mask, __m256d b) {
+    _mm256_maskstore_pd(a, _mm256_castpd_si256(mask), b);
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_maskStoreRegister<float>(float *a, __m256 mask, __m256 b) {
+    _mm256_maskstore_ps(a, _mm256_castps_si256(mask), b);
+}
+
+#endif
+
+
+/**
+ * Store method for unalligned registers
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         Pointer to the destination of the register data
+ * @param b         Register to be stored
+ */
+template<typename T, class regType>
+void mm_storeRegisteru(T *, regType);
+
+#ifdef __AVX__
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegisteru<double>(double *a, __m256d b) {
+    _mm256_storeu_pd(a, b);
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegisteru<float>(float *a, __m256 b) {
+    _mm256_storeu_ps(a, b);
+}
+
+#endif
+
+#ifdef __AVX512F__
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegisteru<double>(double *a, __m512d b) {
+    _mm512_storeu_pd(a, b);
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegisteru<float>(float *a, __m512 b) {
+    _mm512_storeu_ps(a, b);
+}
+
+#endif
+
+
+/**
+ * Store method for alligned registers
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param a         Pointer to the destination of the register data
+ * @param b         Register to be stored
+ */
+template<typename T, class regType>
+void mm_storeRegister(T *, regType);
+
+#ifdef __AVX__
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegister<double>(double *a, __m256d b) {
+    _mm256_store_pd(a, b);
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegister<float>(float *a, __m256 b) {
+    _mm256_store_ps(a, b);
+}
+
+#endif
+
+#ifdef __AVX512F__
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegister<double>(double *a, __m512d b) {
+    _mm512_store_pd(a, b);
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegister<float>(float *a, __m512 b) {
+    _mm512_store_ps(a, b);
+}
+
+#endif
+
+
+//------------------------------------- 16 bit storage types ---------------------------------------
+
+/*
+ * The 16 bit storage types are loaded into float registers and rounded back
+ * when stored, so a register holds as many entries as the float one. The
+ * memory read or written is half the size of the register.
+ */
+
+#ifdef __AVX2__
+
+/**
+ * Rounds the floats of a register to the nearest even bfloat16
+ * @param b         Register with the floats
+ * @return          The upper 16 bits of each float, packed in order
+ */
+inline __m128i __attribute__((__always_inline__))
+mm_roundBfloat16(__m256 b) {
+    const __m256i wide = _mm256_castps_si256(b);
+    const __m256i upper = _mm256_srli_epi32(wide, 16);
+    const __m256i bias = _mm256_add_epi32(_mm256_and_si256(upper, _mm256_set1_epi32(1)),
+                                          _mm256_set1_epi32(0x7FFF));
+    const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(b, b, _CMP_UNORD_Q));
+    const __m256i rounded = _mm256_blendv_epi8(_mm256_srli_epi32(_mm256_add_epi32(wide, bias), 16),
+                                               _mm256_or_si256(upper, _mm256_set1_epi32(0x40)), nan);
+
+    // The pack works within each 128 bit lane, the permutation joins both halves
+    return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(rounded, rounded), 0xD8));
+}
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_loadRegister<anpi::bfloat16>(const anpi::bfloat16 *a) {
+    const __m128i bits = _mm_load_si128(reinterpret_cast<const __m128i *>(a));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(bits), 16));
+}
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_loadRegisteru<anpi::bfloat16>(const anpi::bfloat16 *a) {
+    const __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(bits), 16));
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegister<anpi::bfloat16>(anpi::bfloat16 *a, __m256 b) {
+    _mm_store_si128(reinterpret_cast<__m128i *>(a), mm_roundBfloat16(b));
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegisteru<anpi::bfloat16>(anpi::bfloat16 *a, __m256 b) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(a), mm_roundBfloat16(b));
+}
+
+#endif
+
+#if defined(__AVX__) && defined(__F16C__)
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_loadRegister<anpi::half>(const anpi::half *a) {
+    return _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i *>(a)));
+}
+
+template<>
+inline __m256 __attribute__((__always_inline__))
+mm_loadRegisteru<anpi::half>(const anpi::half *a) {
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a)));
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegister<anpi::half>(anpi::half *a, __m256 b) {
+    _mm_store_si128(reinterpret_cast<__m128i *>(a), _mm256_cvtps_ph(b, _MM_FROUND_TO_NEAREST_INT));
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegisteru<anpi::half>(anpi::half *a, __m256 b) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(a), _mm256_cvtps_ph(b, _MM_FROUND_TO_NEAREST_INT));
+}
+
+#endif
+
+#ifdef __AVX512F__
+
+/**
+ * Rounds the floats of a register to the nearest even bfloat16
+ * @param b         Register with the floats
+ * @return          The upper 16 bits of each float, packed in order
+ */
+inline __m256i __attribute__((__always_inline__))
+mm_roundBfloat16(__m512 b) {
+    const __m512i wide = _mm512_castps_si512(b);
+    const __m512i upper = _mm512_srli_epi32(wide, 16);
+    const __m512i bias = _mm512_add_epi32(_mm512_and_si512(upper, _mm512_set1_epi32(1)),
+                                          _mm512_set1_epi32(0x7FFF));
+    const __mmask16 nan = _mm512_cmp_ps_mask(b, b, _CMP_UNORD_Q);
+    const __m512i rounded = _mm512_mask_or_epi32(_mm512_srli_epi32(_mm512_add_epi32(wide, bias), 16),
+                                                  nan, upper, _mm512_set1_epi32(0x40));
+
+    return _mm512_cvtepi32_epi16(rounded);
+}
+
+template<>
+inline __m512 __attribute__((__always_inline__))
+mm_loadRegister<anpi::bfloat16>(const anpi::bfloat16 *a) {
+    const __m256i bits = _mm256_load_si256(reinterpret_cast<const __m256i *>(a));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(bits), 16));
+}
+
+template<>
+inline __m512 __attribute__((__always_inline__))
+mm_loadRegisteru<anpi::bfloat16>(const anpi::bfloat16 *a) {
+    const __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(bits), 16));
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegister<anpi::bfloat16>(anpi::bfloat16 *a, __m512 b) {
+    _mm256_store_si256(reinterpret_cast<__m256i *>(a), mm_roundBfloat16(b));
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegisteru<anpi::bfloat16>(anpi::bfloat16 *a, __m512 b) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(a), mm_roundBfloat16(b));
+}
+
+#ifdef __F16C__
+
+template<>
+inline __m512 __attribute__((__always_inline__))
+mm_loadRegister<anpi::half>(const anpi::half *a) {
+    return _mm512_cvtph_ps(_mm256_load_si256(reinterpret_cast<const __m256i *>(a)));
+}
+
+template<>
+inline __m512 __attribute__((__always_inline__))
+mm_loadRegisteru<anpi::half>(const anpi::half *a) {
+    return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a)));
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegister<anpi::half>(anpi::half *a, __m512 b) {
+    _mm256_store_si256(reinterpret_cast<__m256i *>(a), _mm512_cvtps_ph(b, _MM_FROUND_TO_NEAREST_INT));
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_storeRegisteru<anpi::half>(anpi::half *a, __m512 b) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(a), _mm512_cvtps_ph(b, _MM_FROUND_TO_NEAREST_INT));
+}
+
+#endif
+
+#endif
+
+
+/**
+ * Transposes a square block held in registers, one row of the block per
+ * register. The block is 4x4 for double and 8x8 for float
+ * @tparam T        Datatype
+ * @tparam regType  Register datatype
+ * @param r         Registers with the rows of the block, they end up holding its columns
+ */
+template<typename T, class regType>
+void mm_transpose(regType *);
+
+#ifdef __AVX__
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_transpose<double>(__m256d *r) {
+    // Pairs of rows interleaved within each 128 bit lane
+    const __m256d t0 = _mm256_unpacklo_pd(r[0], r[1]);
+    const __m256d t1 = _mm256_unpackhi_pd(r[0], r[1]);
+    const __m256d t2 = _mm256_unpacklo_pd(r[2], r[3]);
+    const __m256d t3 = _mm256_unpackhi_pd(r[2], r[3]);
+
+    // Lanes exchanged between the pairs
+    r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+template<>
+inline void __attribute__((__always_inline__))
+mm_transpose<float>(__m256 *r) {
+    // Pairs of rows interleaved within each 128 bit lane
+    const __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+
+    // 4x4 blocks transposed within each 128 bit lane
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+    // Lanes exchanged between the 4x4 blocks
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+#endif
 
 
 
@@ -16,11 +16,117 @@
 #include "Matrix.hpp"
 #include "Exception.hpp"
 #include "IntrinsicsMethods.hpp"
+#include "ParallelOptions.hpp"
 #include <functional>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 namespace anpi {
     namespace fallback {
+        /*
+         * Row blocks
+         */
+
+        // Run kernel(i) for each row i of a matrix. The rows are split in
+        // blocks among the threads following the schedule of the options.
+        // With the default static schedule each thread takes the same
+        // contiguous block on every call for matrices of the same size, so
+        // on multi-socket machines the pages first touched by a thread,
+        // e.g. by fill, are used by the same thread from its own node
+        template<class Kernel>
+        inline void forRows(const size_t rows,
+                            const size_t cols,
+                            const ParallelOptions &parallel,
+                            Kernel kernel) {
+
+            const int threads = parallel.threadsFor(rows * cols, rows);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+            for (size_t i = 0; i < rows; ++i) {
+                kernel(i);
+            }
+        }
+
+
+        /*
+         * Element-wise expressions
+         */
+
+        // Implementation c = e, one entry at a time. Each entry of c is
+        // written after the entries of the operands at its position are
+        // read, so the expression may read c
+        template<typename T, class Alloc, class E>
+        inline void assign(Matrix <T, Alloc> &c,
+                           const E &e,
+                           const ParallelOptions &parallel = elementWiseParallel()) {
+
+            assert((c.rows() == e.rows()) && (c.cols() == e.cols()));
+
+            const size_t cols = c.cols();
+
+            forRows(c.rows(), cols, parallel, [&](const size_t i) {
+                T *row = c[i];
+                for (size_t j = 0; j < cols; ++j) {
+                    row[j] = e.entry(i, j);
+                }
+            });
+        }
+
+        // Sum of the entries of e, each row is summed on its own
+        template<class E>
+        inline typename E::value_type sum(const E &e,
+                                          const ParallelOptions &parallel = elementWiseParallel()) {
+            typedef typename E::value_type T;
+
+            const size_t rows = e.rows();
+            const size_t cols = e.cols();
+            const int threads = parallel.threadsFor(rows * cols, rows);
+
+            T total = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) reduction(+:total) if (threads > 1)
+#endif
+            for (size_t i = 0; i < rows; ++i) {
+                T row = T(0);
+                for (size_t j = 0; j < cols; ++j) {
+                    row += e.entry(i, j);
+                }
+                total += row;
+            }
+
+            return total;
+        }
+
+        // Largest magnitude of the entries of e, zero if e is empty
+        template<class E>
+        inline typename E::value_type maxAbs(const E &e,
+                                             const ParallelOptions &parallel = elementWiseParallel()) {
+            typedef typename E::value_type T;
+
+            const size_t rows = e.rows();
+            const size_t cols = e.cols();
+            const int threads = parallel.threadsFor(rows * cols, rows);
+
+            T largest = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) reduction(max:largest) if (threads > 1)
+#endif
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < cols; ++j) {
+                    largest = std::max(largest, T(std::abs(e.entry(i, j))));
+                }
+            }
+
+            return largest;
+        }
+
+
         /*
          * Sum
          */
@@ -31,42 +137,26 @@ namespace anpi {
         template<typename T, class Alloc>
         inline void add(const Matrix <T, Alloc> &a,
                         const Matrix <T, Alloc> &b,
-                        Matrix <T, Alloc> &c) {
+                        Matrix <T, Alloc> &c,
+                        const ParallelOptions &parallel = elementWiseParallel()) {
 
             assert((a.rows() == b.rows()) &&
                    (a.cols() == b.cols()));
 
-            const size_t tentries = a.rows() * a.dcols();
             c.allocate(a.rows(), a.cols());
-
-            T *here = c.data();
-            T *const end = here + tentries;
-            const T *aptr = a.data();
-            const T *bptr = b.data();
-
-            for (; here != end;) {
-                *here++ = *aptr++ + *bptr++;
-            }
+            assign(c, a + b, parallel);
         }
 
         // In-place implementation a = a+b
         template<typename T, class Alloc>
         inline void add(Matrix <T, Alloc> &a,
-                        const Matrix <T, Alloc> &b) {
+                        const Matrix <T, Alloc> &b,
+                        const ParallelOptions &parallel = elementWiseParallel()) {
 
             assert((a.rows() == b.rows()) &&
                    (a.cols() == b.cols()));
 
-            const size_t tentries = a.rows() * a.dcols();
-
-            T *here = a.data();
-            T *const end = here + tentries;
-
-            const T *bptr = b.data();
-
-            for (; here != end;) {
-                *here++ += *bptr++;
-            }
+            assign(a, a + b, parallel);
         }
 
 
@@ -80,122 +170,195 @@ namespace anpi {
         template<typename T, class Alloc>
         inline void subtract(const Matrix <T, Alloc> &a,
                              const Matrix <T, Alloc> &b,
-                             Matrix <T, Alloc> &c) {
+                             Matrix <T, Alloc> &c,
+                             const ParallelOptions &parallel = elementWiseParallel()) {
 
             assert((a.rows() == b.rows()) &&
                    (a.cols() == b.cols()));
 
-            const size_t tentries = a.rows() * a.dcols();
             c.allocate(a.rows(), a.cols());
-
-            T *here = c.data();
-            T *const end = here + tentries;
-            const T *aptr = a.data();
-            const T *bptr = b.data();
-
-            for (; here != end;) {
-                *here++ = *aptr++ - *bptr++;
-            }
+            assign(c, a - b, parallel);
         }
 
         // In-place implementation a = a-b
         template<typename T, class Alloc>
         inline void subtract(Matrix <T, Alloc> &a,
-                             const Matrix <T, Alloc> &b) {
+                             const Matrix <T, Alloc> &b,
+                             const ParallelOptions &parallel = elementWiseParallel()) {
 
             assert((a.rows() == b.rows()) &&
                    (a.cols() == b.cols()));
 
-            const size_t tentries = a.rows() * a.dcols();
+            assign(a, a - b, parallel);
+        }
 
-            T *here = a.data();
-            T *const end = here + tentries;
 
-            const T *bptr = b.data();
+        // In-copy implementation c=a*b. Each row of c accumulates the rows
+        // of b weighted by a row of a, so all the accesses are sequential
+        template<typename T, class Alloc>
+        inline void multiplicate(const Matrix <T, Alloc> &a,
+                                 const Matrix <T, Alloc> &b,
+                                 Matrix <T, Alloc> &mult) {
 
-            for (; here != end;) {
-                *here++ -= *bptr++;
+            //Se verifica que las matrices sean compatibles para
+            //realizar la multiplicacion
+            if (a.cols() != b.rows()) {
+                throw anpi::Exception("Las dimensiones de las matrices no son compatibles");
             }
-        }
 
+            assert((&mult != &a) && (&mult != &b));
+
+            //Se crea la matriz resultante y se inicializa en 0
+            mult.allocate(a.rows(), b.cols());
+            mult.fill(T(0));
+
+            // Se hace la multiplicacion y se almacena en la matriz resultante
+            for (size_t i = 0; i < a.rows(); ++i) {
+                T *row = mult[i];
+                const T *arow = a[i];
+
+                for (size_t k = 0; k < a.cols(); ++k) {
+                    const T factor = arow[k];
+                    const T *brow = b[k];
+
+                    for (size_t j = 0; j < b.cols(); ++j) {
+                        row[j] += factor * brow[j];
+                    }
+                }
+            }
+        }
 
         // In-place implementation a = a*b
         template<typename T, class Alloc>
         inline void multiplicate(Matrix <T, Alloc> &a,
                                  const Matrix <T, Alloc> &b) {
 
-            //Se verifica que las matrices sean compatibles para
-            //realizar la multiplicacion
-            if (a.cols() != b.rows()) {
-                throw anpi::Exception("Las dimensiones de las matrices no son compatibles");
-            } else {
-                //Se crea la matriz resultante y se inicializa en 0
-                Matrix<T> mult;
-                mult.allocate(a.rows(), b.cols());
-                mult.fill(T(0));
-                // Se hace la multiplicacion y se almacena en la matriz resultante
-                for (unsigned int i = 0; i < a.rows(); ++i) {
+            // The product is copied back, so a keeps its allocator
+            Matrix <T, Alloc> mult(a.resultAllocator());
+            multiplicate(a, b, mult);
+            a = mult;
+        }
 
-                    for (unsigned int j = 0; j < b.cols(); ++j) {
+        /*
+         * Matrix-vector product
+         */
 
-                        for (unsigned int k = 0; k < a.cols(); ++k) {
+        // Implementation y = a*x, x holds a.cols() entries and y a.rows().
+        // The parallel options are only taken for the same interface as
+        // the SIMD implementation
+        template<typename T, class Alloc>
+        inline void multiplicate(const Matrix <T, Alloc> &a,
+                                 const T *x,
+                                 T *y,
+                                 const ParallelOptions & = ParallelOptions()) {
+
+            for (size_t i = 0; i < a.rows(); ++i) {
+                const T *row = a[i];
+                T sum = T(0);
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    sum += row[j] * x[j];
+                }
+                y[i] = sum;
+            }
+        }
 
-                            mult(i, j) += a(i, k) * b(k, j);
-                        }
+        // Implementation y = a^T*x, x holds a.rows() entries and y a.cols()
+        template<typename T, class Alloc>
+        inline void multiplicateTransposed(const Matrix <T, Alloc> &a,
+                                           const T *x,
+                                           T *y,
+                                           const ParallelOptions & = ParallelOptions()) {
+
+            std::fill(y, y + a.cols(), T(0));
+            for (size_t i = 0; i < a.rows(); ++i) {
+                const T *row = a[i];
+                const T factor = x[i];
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    y[j] += factor * row[j];
+                }
+            }
+        }
+
+        // Entry-wise comparison a >= b of matrices of the same size
+        template<typename T, typename U, class Alloc>
+        inline bool greaterEqual(const Matrix <T, Alloc> &a,
+                                 const Matrix <U, Alloc> &b) {
+
+            assert((a.rows() == b.rows()) && (a.cols() == b.cols()));
+
+            for (size_t i = 0; i < a.rows(); ++i) {
+                const T *aRow = a[i];
+                const U *bRow = b[i];
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    if (!(aRow[j] >= bRow[j])) {
+                        return false;
                     }
                 }
-                a = mult;
             }
+
+            return true;
         }
 
+        /*
+         * Transposition
+         */
+
+        // Side, in entries, of the square tiles of the blocked
+        // transposition. One tile of the source and one of the destination
+        // fit together in the L1 cache, so the column-wise writes of a tile
+        // hit lines that are still cached
+        constexpr size_t transposeTile = 32;
 
-        // In-copy implementation c=a*b
+        // In-copy implementation c = a^T
         template<typename T, class Alloc>
-        inline void multiplicate(const Matrix <T, Alloc> &a,
-                                 const Matrix <T, Alloc> &b,
-                                 Matrix <T, Alloc> &mult) {
+        inline void transpose(const Matrix <T, Alloc> &a,
+                              Matrix <T, Alloc> &c) {
 
-            //Se verifica que las matrices sean compatibles para
-            //realizar la multiplicacion
-            if (a.cols() != b.rows()) {
-                throw anpi::Exception("Las dimensiones de las matrices no son compatibles");
-            } else {
-                //Se crea la matriz resultante y se inicializa en 0
-                mult.fill(T(0));
-                // Se hace la multiplicacion y se almacena en la matriz resultante
-                for (unsigned int i = 0; i < a.rows(); ++i) {
+            assert(&a != &c);
 
-                    for (unsigned int j = 0; j < b.cols(); ++j) {
+            const size_t rows = a.rows();
+            const size_t cols = a.cols();
+            c.allocate(cols, rows);
 
-                        for (unsigned int k = 0; k < a.cols(); ++k) {
+            for (size_t ib = 0; ib < rows; ib += transposeTile) {
+                const size_t iEnd = std::min(ib + transposeTile, rows);
 
-                            mult(i, j) += a(i, k) * b(k, j);
+                for (size_t jb = 0; jb < cols; jb += transposeTile) {
+                    const size_t jEnd = std::min(jb + transposeTile, cols);
+
+                    for (size_t i = ib; i < iEnd; ++i) {
+                        const T *src = a[i];
+                        for (size_t j = jb; j < jEnd; ++j) {
+                            c[j][i] = src[j];
                         }
                     }
                 }
             }
         }
 
-        // In-copy implementation C = A/b
-        template<typename T, typename U, class Alloc>
-        inline void divide(const Matrix <T, Alloc> &a,
-                           Matrix <T, Alloc> &div,
-                           const U factor) {
+        // In-place implementation a = a^T, only for square matrices
+        template<typename T, class Alloc>
+        inline void transpose(Matrix <T, Alloc> &a) {
 
-            if (factor == U(0)) {
-                throw anpi::Exception("Se intentó dividir todos los elementos de la matriz por cero");
-            } else {
+            assert(a.rows() == a.cols());
 
-                T fct = T(factor);
-                //Se itera dividiendo entre cada elemnto de la matriz
-                for (size_t i = 0; i < a.rows(); ++i) {
+            const size_t n = a.rows();
 
-                    for (size_t j = 0; j < a.cols(); ++j) {
-                        div(i, j) = a(i, j) / fct;
-                    }
+            // Only the tiles on and above the diagonal are visited, each one
+            // is swapped with its mirror below the diagonal
+            for (size_t ib = 0; ib < n; ib += transposeTile) {
+                const size_t iEnd = std::min(ib + transposeTile, n);
 
-                }
+                for (size_t jb = ib; jb < n; jb += transposeTile) {
+                    const size_t jEnd = std::min(jb + transposeTile, n);
 
+                    for (size_t i = ib; i < iEnd; ++i) {
+                        T *row = a[i];
+                        for (size_t j = std::max(jb, i + 1); j < jEnd; ++j) {
+                            std::swap(row[j], a[j][i]);
+                        }
+                    }
+                }
             }
         }
 
@@ -205,165 +368,246 @@ namespace anpi {
     namespace simd {
 
 
-        // On-copy implementation c=a+b
-        template<typename T, class Alloc, typename regType>
-        inline void addSIMD(const Matrix <T, Alloc> &a,
-                            const Matrix <T, Alloc> &b,
-                            Matrix <T, Alloc> &c) {
-
-            // This method is instantiated with unaligned allocators.  We
-            // allow the instantiation although externally this is never
-            // called unaligned
-            static_assert(!extract_alignment<Alloc>::aligned ||
-                          (extract_alignment<Alloc>::value >= sizeof(regType)),
-                          "Insufficient alignment for the registers used");
-
-            const size_t tentries = a.rows() * a.dcols();
-            c.allocate(a.rows(), a.cols());
+        /*
+         * Element-wise expressions
+         */
 
-            regType *here = reinterpret_cast<regType *>(c.data());
-            const size_t blocks = (tentries * sizeof(T) + (sizeof(regType) - 1)) /
-                                  sizeof(regType);
-            regType *const end = here + blocks;
-            const regType *aptr = reinterpret_cast<const regType *>(a.data());
-            const regType *bptr = reinterpret_cast<const regType *>(b.data());
+        // Implementation c = e, a register at a time. The expression may
+        // read c, as each register is stored after it is computed
+        template<typename T, class Alloc, class E, typename regType>
+        inline void assignSIMD(Matrix <T, Alloc> &c,
+                               const E &e,
+                               const ParallelOptions &parallel) {
 
-            for (; here != end;) {
-                *here++ = mm_add<T>(*aptr++, *bptr++);
-            }
+            assert((c.rows() == e.rows()) && (c.cols() == e.cols()));
 
-        }
+            constexpr size_t step = sizeof(regType) / sizeof(T);
 
-        // On-copy implementation c=a+b for SIMD-capable types
-        template<typename T,
-                class Alloc,
-                typename std::enable_if<is_simd_type<T>::value, int>::type= 0>
-        inline void add(const Matrix <T, Alloc> &a,
-                        const Matrix <T, Alloc> &b,
-                        Matrix <T, Alloc> &c) {
+            const size_t cols = c.cols();
+            const size_t full = cols - cols % step;
 
-            assert((a.rows() == b.rows()) &&
-                   (a.cols() == b.cols()));
+            ::anpi::fallback::forRows(c.rows(), cols, parallel, [&](const size_t i) {
+                T *row = c[i];
 
+                size_t j = 0;
+                for (; j < full; j += step) {
+                    mm_storeRegisteru<T>(row + j, e.template load<regType>(i, j));
+                }
+                for (; j < cols; ++j) {
+                    row[j] = e.entry(i, j);
+                }
+            });
+        }
 
-            if (is_aligned_alloc<Alloc>::value) {
+        // Element-wise expressions of floating point types
+        template<typename T,
+                class Alloc,
+                class E,
+                typename std::enable_if<std::is_same<T, double>::value ||
+                                        std::is_same<T, float>::value, int>::type = 0>
+        inline void assign(Matrix <T, Alloc> &c,
+                           const E &e,
+                           const ParallelOptions &parallel = elementWiseParallel()) {
 #ifdef __AVX512F__
-                addSIMD<T,Alloc,typename avx512_traits<T>::reg_type>(a,b,c);
+            assignSIMD<T, Alloc, E, typename avx512_traits<T>::reg_type>(c, e, parallel);
 #elif  __AVX__
-                addSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a, b, c);
-#elif  __SSE2__
-                addSIMD<T,Alloc,typename sse2_traits<T>::reg_type>(a,b,c);
+            assignSIMD<T, Alloc, E, typename avx_traits<T>::reg_type>(c, e, parallel);
 #else
-        ::anpi::fallback::add(a,b,c);
+            ::anpi::fallback::assign(c, e, parallel);
 #endif
-            } else { // allocator seems to be unaligned
-                ::anpi::fallback::add(a, b, c);
-            }
         }
 
+        // Other types
+        template<typename T,
+                class Alloc,
+                class E,
+                typename std::enable_if<!(std::is_same<T, double>::value ||
+                                          std::is_same<T, float>::value), int>::type = 0>
+        inline void assign(Matrix <T, Alloc> &c,
+                           const E &e,
+                           const ParallelOptions &parallel = elementWiseParallel()) {
+            ::anpi::fallback::assign(c, e, parallel);
+        }
 
-        // On-copy implementation c=a-b
-        template<typename T, class Alloc, typename regType>
-        inline void subSIMD(const Matrix <T, Alloc> &a,
-                            const Matrix <T, Alloc> &b,
-                            Matrix <T, Alloc> &c) {
-
-            // This method is instantiated with unaligned allocators.  We
-            // allow the instantiation although externally this is never
-            // called unaligned
-            static_assert(!extract_alignment<Alloc>::aligned ||
-                          (extract_alignment<Alloc>::value >= sizeof(regType)),
-                          "Insufficient alignment for the registers used");
-
-            const size_t tentries = a.rows() * a.dcols();
-            c.allocate(a.rows(), a.cols());
 
-            regType *here = reinterpret_cast<regType *>(c.data());
-            const size_t blocks = (tentries * sizeof(T) + (sizeof(regType) - 1)) /
-                                  sizeof(regType);
-            regType *const end = here + blocks;
-            const regType *aptr = reinterpret_cast<const regType *>(a.data());
-            const regType *bptr = reinterpret_cast<const regType *>(b.data());
+        /*
+         * Reductions
+         */
+
+        // Sum of the entries of e. Each row accumulates registers, which
+        // are added up at its end
+        template<class E, typename regType>
+        inline typename E::value_type sumSIMD(const E &e,
+                                              const ParallelOptions &parallel) {
+            typedef typename E::value_type T;
+
+            constexpr size_t step = sizeof(regType) / sizeof(T);
 
+            const size_t rows = e.rows();
+            const size_t cols = e.cols();
+            const size_t full = cols - cols % step;
+            const int threads = parallel.threadsFor(rows * cols, rows);
 
-            for (; here != end;) {
-                *here++ = mm_sub<T>(*aptr++, *bptr++);
+            T total = T(0);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) reduction(+:total) if (threads > 1)
+#endif
+            for (size_t i = 0; i < rows; ++i) {
+                regType acc = mm_set1<T, regType>(T(0));
+
+                size_t j = 0;
+                for (; j < full; j += step) {
+                    acc = mm_add<T>(acc, e.template load<regType>(i, j));
+                }
+
+                alignas(sizeof(regType)) T lanes[step];
+                mm_storeRegister<T>(lanes, acc);
+
+                T row = T(0);
+                for (size_t k = 0; k < step; ++k) {
+                    row += lanes[k];
+                }
+                for (; j < cols; ++j) {
+                    row += e.entry(i, j);
+                }
+                total += row;
             }
 
+            return total;
         }
 
+        // Largest magnitude of the entries of e, as the maximum of the
+        // entries and their negatives
+        template<class E, typename regType>
+        inline typename E::value_type maxAbsSIMD(const E &e,
+                                                 const ParallelOptions &parallel) {
+            typedef typename E::value_type T;
 
-        // On-copy implementation c=a-b for SIMD-capable types
-        template<typename T,
-                class Alloc,
-                typename std::enable_if<is_simd_type<T>::value, int>::type= 0>
-        inline void subtract(const Matrix <T, Alloc> &a,
-                             const Matrix <T, Alloc> &b,
-                             Matrix <T, Alloc> &c) {
-
-            assert((a.rows() == b.rows()) &&
-                   (a.cols() == b.cols()));
+            constexpr size_t step = sizeof(regType) / sizeof(T);
 
+            const size_t rows = e.rows();
+            const size_t cols = e.cols();
+            const size_t full = cols - cols % step;
+            const int threads = parallel.threadsFor(rows * cols, rows);
 
-            if (is_aligned_alloc<Alloc>::value) {
-#ifdef  __AVX__
-                subSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a, b, c);
+            T largest = T(0);
 
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) reduction(max:largest) if (threads > 1)
 #endif
-            } else { // allocator seems to be unaligned
-                ::anpi::fallback::subtract(a, b, c);
+            for (size_t i = 0; i < rows; ++i) {
+                const regType zero = mm_set1<T, regType>(T(0));
+                regType acc = zero;
+
+                size_t j = 0;
+                for (; j < full; j += step) {
+                    const regType entries = e.template load<regType>(i, j);
+                    acc = mm_max<T>(acc, mm_max<T>(entries, mm_sub<T>(zero, entries)));
+                }
+
+                alignas(sizeof(regType)) T lanes[step];
+                mm_storeRegister<T>(lanes, acc);
+
+                for (size_t k = 0; k < step; ++k) {
+                    largest = std::max(largest, lanes[k]);
+                }
+                for (; j < cols; ++j) {
+                    largest = std::max(largest, T(std::abs(e.entry(i, j))));
+                }
             }
+
+            return largest;
         }
 
-        // On-copy implementation C = A/b
-        template<typename T, class Alloc, typename regType>
-        inline void divSIMD(const Matrix <T, Alloc> &a,
-                            const Matrix <T, Alloc> &factor,
-                            Matrix <T, Alloc> &c) {
-
-            // This method is instantiated with unaligned allocators.  We
-            // allow the instantiation although externally this is never
-            // called unaligned
-            static_assert(!extract_alignment<Alloc>::aligned ||
-                          (extract_alignment<Alloc>::value >= sizeof(regType)),
-                          "Insufficient alignment for the registers used");
-
-            const size_t tentries = a.rows() * a.dcols();
-            c.allocate(a.rows(), a.cols());
+        // Reductions of floating point types
+        template<class E,
+                typename std::enable_if<std::is_same<typename E::value_type, double>::value ||
+                                        std::is_same<typename E::value_type, float>::value, int>::type = 0>
+        inline typename E::value_type sum(const E &e,
+                                          const ParallelOptions &parallel = elementWiseParallel()) {
+#ifdef __AVX512F__
+            return sumSIMD<E, typename avx512_traits<typename E::value_type>::reg_type>(e, parallel);
+#elif  __AVX__
+            return sumSIMD<E, typename avx_traits<typename E::value_type>::reg_type>(e, parallel);
+#else
+            return ::anpi::fallback::sum(e, parallel);
+#endif
+        }
 
-            regType *here = reinterpret_cast<regType *>(c.data());
-            const size_t blocks = (tentries * sizeof(T) + (sizeof(regType) - 1)) /
-                                  sizeof(regType);
-            regType *const end = here + blocks;
-            const regType *aptr = reinterpret_cast<const regType *>(a.data());
-            const regType *bptr = reinterpret_cast<const regType *>(factor.data());
+        template<class E,
+                typename std::enable_if<std::is_same<typename E::value_type, double>::value ||
+                                        std::is_same<typename E::value_type, float>::value, int>::type = 0>
+        inline typename E::value_type maxAbs(const E &e,
+                                             const ParallelOptions &parallel = elementWiseParallel()) {
+#ifdef __AVX512F__
+            return maxAbsSIMD<E, typename avx512_traits<typename E::value_type>::reg_type>(e, parallel);
+#elif  __AVX__
+            return maxAbsSIMD<E, typename avx_traits<typename E::value_type>::reg_type>(e, parallel);
+#else
+            return ::anpi::fallback::maxAbs(e, parallel);
+#endif
+        }
 
-            for (; here != end;) {
-                *here++ = mm_div<T>(*aptr++, *bptr++);
-            }
+        // Other types
+        template<class E,
+                typename std::enable_if<!(std::is_same<typename E::value_type, double>::value ||
+                                          std::is_same<typename E::value_type, float>::value), int>::type = 0>
+        inline typename E::value_type sum(const E &e,
+                                          const ParallelOptions &parallel = elementWiseParallel()) {
+            return ::anpi::fallback::sum(e, parallel);
+        }
 
+        template<class E,
+                typename std::enable_if<!(std::is_same<typename E::value_type, double>::value ||
+                                          std::is_same<typename E::value_type, float>::value), int>::type = 0>
+        inline typename E::value_type maxAbs(const E &e,
+                                             const ParallelOptions &parallel = elementWiseParallel()) {
+            return ::anpi::fallback::maxAbs(e, parallel);
         }
 
 
-        // On-copy implementation c=a-b for SIMD-capable types
+        /*
+         * Sum
+         */
+
+        // On-copy implementation c=a+b for SIMD-capable types, as the
+        // expression a+b
         template<typename T,
                 class Alloc,
                 typename std::enable_if<is_simd_type<T>::value, int>::type= 0>
-        inline void divide(const Matrix <T, Alloc> &a,
-                           const Matrix <T, Alloc> &b,//factor
-                           Matrix <T, Alloc> &c) {
+        inline void add(const Matrix <T, Alloc> &a,
+                        const Matrix <T, Alloc> &b,
+                        Matrix <T, Alloc> &c,
+                        const ParallelOptions &parallel = elementWiseParallel()) {
 
             assert((a.rows() == b.rows()) &&
                    (a.cols() == b.cols()));
 
+            c.allocate(a.rows(), a.cols());
+            assign(c, a + b, parallel);
+        }
 
-            if (is_aligned_alloc<Alloc>::value) {
-#ifdef __AVX__
-                divSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a, b, c);
-#endif
-            } else { // allocator seems to be unaligned
-                ::anpi::fallback::divide(a, c, b(0, 0));
-            }
+
+        /*
+         * Subtraction
+         */
+
+        // On-copy implementation c=a-b for SIMD-capable types, as the
+        // expression a-b
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<is_simd_type<T>::value, int>::type= 0>
+        inline void subtract(const Matrix <T, Alloc> &a,
+                             const Matrix <T, Alloc> &b,
+                             Matrix <T, Alloc> &c,
+                             const ParallelOptions &parallel = elementWiseParallel()) {
+
+            assert((a.rows() == b.rows()) &&
+                   (a.cols() == b.cols()));
+
+            c.allocate(a.rows(), a.cols());
+            assign(c, a - b, parallel);
         }
 
         // Non-SIMD types such as complex
@@ -372,17 +616,19 @@ namespace anpi {
                 typename std::enable_if<!is_simd_type<T>::value, int>::type = 0>
         inline void add(const Matrix <T, Alloc> &a,
                         const Matrix <T, Alloc> &b,
-                        Matrix <T, Alloc> &c) {
+                        Matrix <T, Alloc> &c,
+                        const ParallelOptions &parallel = elementWiseParallel()) {
 
-            ::anpi::fallback::add(a, b, c);
+            ::anpi::fallback::add(a, b, c, parallel);
         }
 
         // In-place implementation a = a+b
         template<typename T, class Alloc>
         inline void add(Matrix <T, Alloc> &a,
-                        const Matrix <T, Alloc> &b) {
+                        const Matrix <T, Alloc> &b,
+                        const ParallelOptions &parallel = elementWiseParallel()) {
 
-            add(a, b, a);
+            add(a, b, a, parallel);
         }
 
 
@@ -398,43 +644,745 @@ namespace anpi {
                 typename std::enable_if<!is_simd_type<T>::value, int>::type = 0>
         inline void subtract(const Matrix <T, Alloc> &a,
                              const Matrix <T, Alloc> &b,
-                             Matrix <T, Alloc> &c) {
-            ::anpi::fallback::subtract(a, b, c);
+                             Matrix <T, Alloc> &c,
+                             const ParallelOptions &parallel = elementWiseParallel()) {
+            ::anpi::fallback::subtract(a, b, c, parallel);
         }
 
         // In-place implementation a = a-b
         template<typename T, class Alloc>
         inline void subtract(Matrix <T, Alloc> &a,
-                             const Matrix <T, Alloc> &b) {
+                             const Matrix <T, Alloc> &b,
+                             const ParallelOptions &parallel = elementWiseParallel()) {
 
-            subtract(a, b, a);
+            subtract(a, b, a, parallel);
         }
 
 
 
         /*
-         * Division
+         * Comparison
          */
 
-        // Fall back implementations
+        // Implementation a >= b, a register at a time. It stops at the
+        // first register with an entry of a smaller than the one of b
+        template<typename T, class Alloc, typename regType>
+        inline bool greaterEqualSIMD(const Matrix <T, Alloc> &a,
+                                     const Matrix <T, Alloc> &b) {
 
-        // In-copy implementation c=a-b
+            assert((a.rows() == b.rows()) && (a.cols() == b.cols()));
+
+            constexpr size_t step = sizeof(regType) / sizeof(T);
+
+            const size_t cols = a.cols();
+            const size_t full = cols - cols % step;
+
+            for (size_t i = 0; i < a.rows(); ++i) {
+                const T *aRow = a[i];
+                const T *bRow = b[i];
+
+                size_t j = 0;
+                for (; j < full; j += step) {
+                    if (!mm_allGreaterEqual<T>(mm_loadRegisteru<T, regType>(aRow + j),
+                                               mm_loadRegisteru<T, regType>(bRow + j))) {
+                        return false;
+                    }
+                }
+                for (; j < cols; ++j) {
+                    if (!(aRow[j] >= bRow[j])) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        // Comparison of floating point types
         template<typename T,
                 class Alloc,
-                typename std::enable_if<!is_simd_type<T>::value, int>::type = 0>
-        inline void divide(const Matrix <T, Alloc> &a,
-                           const Matrix <T, Alloc> &factor,
-                           Matrix <T, Alloc> &c) {
-            ::anpi::fallback::divide(a, c, factor(0, 0));
+                typename std::enable_if<std::is_same<T, double>::value ||
+                                        std::is_same<T, float>::value, int>::type = 0>
+        inline bool greaterEqual(const Matrix <T, Alloc> &a,
+                                 const Matrix <T, Alloc> &b) {
+#ifdef __AVX512F__
+            return greaterEqualSIMD<T, Alloc, typename avx512_traits<T>::reg_type>(a, b);
+#elif  __AVX__
+            return greaterEqualSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a, b);
+#else
+            return ::anpi::fallback::greaterEqual(a, b);
+#endif
+        }
+
+        // Other types, or matrices of different types
+        template<typename T,
+                typename U,
+                class Alloc,
+                typename std::enable_if<!(std::is_same<T, U>::value &&
+                                          (std::is_same<T, double>::value ||
+                                           std::is_same<T, float>::value)), int>::type = 0>
+        inline bool greaterEqual(const Matrix <T, Alloc> &a,
+                                 const Matrix <U, Alloc> &b) {
+            return ::anpi::fallback::greaterEqual(a, b);
+        }
+
+
+        /*
+         * Multiplication
+         */
+
+        // Blocking of the packed product c = a*b. A block of mc x kc
+        // entries of a stays in the L2 cache and a micro-panel of kc x nr
+        // entries of b in the L1 cache, while a block of mr x nr entries
+        // of c is accumulated in registers
+        template<typename T, typename regType>
+        struct gemm_blocking {
+            /// Entries of a register
+            static constexpr size_t step = sizeof(regType) / sizeof(T);
+
+            /// Rows of the block of c held in registers
+            static constexpr size_t mr = 6;
+
+            /// Columns of the block of c held in registers, two registers per row
+            static constexpr size_t nr = 2 * step;
+
+            /// Depth of the packed panels
+            static constexpr size_t kc = 256;
+
+            /// Rows of the packed block of a
+            static constexpr size_t mc = 16 * mr * (sizeof(double) / sizeof(T));
+
+            /// Columns of the packed panel of b
+            static constexpr size_t nc = 4096;
+
+            static_assert(nc % nr == 0, "The panel of b must hold whole micro-panels");
+        };
+
+        // Copies rows [i0, i0+rows) and columns [k0, k0+depth) of a into
+        // micro-panels of mr rows, stored column after column. The rows past
+        // the end of a are zero
+        template<typename T, class Alloc, typename regType>
+        inline void gemmPackA(const Matrix <T, Alloc> &a,
+                              const size_t i0, const size_t rows,
+                              const size_t k0, const size_t depth,
+                              T *packed) {
+
+            constexpr size_t mr = gemm_blocking<T, regType>::mr;
+
+            for (size_t ir = 0; ir < rows; ir += mr) {
+                const size_t height = std::min(mr, rows - ir);
+                const T *src[mr];
+                for (size_t r = 0; r < height; ++r) {
+                    src[r] = a[i0 + ir + r] + k0;
+                }
+
+                for (size_t p = 0; p < depth; ++p) {
+                    size_t r = 0;
+                    for (; r < height; ++r) {
+                        *packed++ = src[r][p];
+                    }
+                    for (; r < mr; ++r) {
+                        *packed++ = T(0);
+                    }
+                }
+            }
         }
 
+        // Copies rows [k0, k0+depth) and columns [j0, j0+cols) of b into
+        // micro-panels of nr columns, stored row after row. The columns past
+        // the end of b are zero
+        template<typename T, class Alloc, typename regType>
+        inline void gemmPackB(const Matrix <T, Alloc> &b,
+                              const size_t k0, const size_t depth,
+                              const size_t j0, const size_t cols,
+                              const size_t jr,
+                              T *packed) {
+
+            constexpr size_t nr = gemm_blocking<T, regType>::nr;
+            const size_t width = std::min(nr, cols - jr);
+
+            for (size_t p = 0; p < depth; ++p) {
+                const T *src = b[k0 + p] + j0 + jr;
+                std::copy(src, src + width, packed);
+                std::fill(packed + width, packed + nr, T(0));
+                packed += nr;
+            }
+        }
+
+        // Product of a packed micro-panel of a and one of b, accumulated on
+        // a block of rows x cols entries of c. The full blocks are read and
+        // written in place, the partial ones through a buffer
+        template<typename T, typename regType>
+        inline void gemmKernel(const size_t depth,
+                               const T *ap,
+                               const T *bp,
+                               T *c,
+                               const size_t ldc,
+                               const size_t rows,
+                               const size_t cols,
+                               const bool accumulate) {
+
+            constexpr size_t step = gemm_blocking<T, regType>::step;
+            constexpr size_t mr = gemm_blocking<T, regType>::mr;
+            constexpr size_t nr = gemm_blocking<T, regType>::nr;
+
+            // Twelve accumulators, two registers of b and a broadcast entry
+            // of a fill the sixteen registers of AVX
+            regType c00 = mm_set1<T, regType>(T(0)), c01 = c00;
+            regType c10 = c00, c11 = c00;
+            regType c20 = c00, c21 = c00;
+            regType c30 = c00, c31 = c00;
+            regType c40 = c00, c41 = c00;
+            regType c50 = c00, c51 = c00;
+
+            for (size_t p = 0; p < depth; ++p) {
+                const regType b0 = mm_loadRegister<T, regType>(bp);
+                const regType b1 = mm_loadRegister<T, regType>(bp + step);
+                regType e;
+
+                e = mm_set1<T, regType>(ap[0]);
+                c00 = mm_fmadd<T>(e, b0, c00);
+                c01 = mm_fmadd<T>(e, b1, c01);
+                e = mm_set1<T, regType>(ap[1]);
+                c10 = mm_fmadd<T>(e, b0, c10);
+                c11 = mm_fmadd<T>(e, b1, c11);
+                e = mm_set1<T, regType>(ap[2]);
+                c20 = mm_fmadd<T>(e, b0, c20);
+                c21 = mm_fmadd<T>(e, b1, c21);
+                e = mm_set1<T, regType>(ap[3]);
+                c30 = mm_fmadd<T>(e, b0, c30);
+                c31 = mm_fmadd<T>(e, b1, c31);
+                e = mm_set1<T, regType>(ap[4]);
+                c40 = mm_fmadd<T>(e, b0, c40);
+                c41 = mm_fmadd<T>(e, b1, c41);
+                e = mm_set1<T, regType>(ap[5]);
+                c50 = mm_fmadd<T>(e, b0, c50);
+                c51 = mm_fmadd<T>(e, b1, c51);
+
+                ap += mr;
+                bp += nr;
+            }
+
+            const regType block[mr][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                                          {c30, c31}, {c40, c41}, {c50, c51}};
 
-        // In-place implementation  A = A/b
+            if (rows == mr && cols == nr) {
+                for (size_t r = 0; r < mr; ++r) {
+                    T *row = c + r * ldc;
+                    for (size_t h = 0; h < 2; ++h) {
+                        regType value = block[r][h];
+                        if (accumulate) {
+                            value = mm_add<T>(value, mm_loadRegisteru<T, regType>(row + h * step));
+                        }
+                        mm_storeRegisteru<T>(row + h * step, value);
+                    }
+                }
+                return;
+            }
+
+            alignas(sizeof(regType)) T buffer[mr * nr];
+            for (size_t r = 0; r < mr; ++r) {
+                mm_storeRegister<T>(buffer + r * nr, block[r][0]);
+                mm_storeRegister<T>(buffer + r * nr + step, block[r][1]);
+            }
+            for (size_t r = 0; r < rows; ++r) {
+                T *row = c + r * ldc;
+                const T *value = buffer + r * nr;
+                for (size_t j = 0; j < cols; ++j) {
+                    row[j] = accumulate ? row[j] + value[j] : value[j];
+                }
+            }
+        }
+
+        // In-copy implementation c=a*b with packed panels. The panel of b
+        // is shared by all threads, which split the blocks of rows of a
+        template<typename T, class Alloc, typename regType>
+        inline void multiplicateSIMD(const Matrix <T, Alloc> &a,
+                                     const Matrix <T, Alloc> &b,
+                                     Matrix <T, Alloc> &c,
+                                     const ParallelOptions &parallel) {
+
+            typedef gemm_blocking<T, regType> blocking;
+            typedef std::vector<T, aligned_allocator<T, sizeof(regType)> > buffer_type;
+
+            const size_t m = a.rows();
+            const size_t n = b.cols();
+            const size_t k = a.cols();
+            c.allocate(m, n);
+
+            if (k == 0) {
+                c.fill(T(0));
+                return;
+            }
+
+            const size_t rowBlocks = (m + blocking::mc - 1) / blocking::mc;
+            const int threads = parallel.threadsFor(m * n, rowBlocks);
+            buffer_type packedB(blocking::kc * std::min(blocking::nc, (n + blocking::nr - 1) /
+                                                                      blocking::nr * blocking::nr));
+
+            for (size_t jc = 0; jc < n; jc += blocking::nc) {
+                const size_t cols = std::min(blocking::nc, n - jc);
+                const size_t panels = (cols + blocking::nr - 1) / blocking::nr;
+
+                for (size_t pc = 0; pc < k; pc += blocking::kc) {
+                    const size_t depth = std::min(blocking::kc, k - pc);
+                    const bool accumulate = pc > 0;
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel num_threads(threads) if (threads > 1)
+#endif
+                    {
+                        buffer_type packedA(blocking::mc * blocking::kc);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp for schedule(static)
+#endif
+                        for (size_t panel = 0; panel < panels; ++panel) {
+                            gemmPackB<T, Alloc, regType>(b, pc, depth, jc, cols, panel * blocking::nr,
+                                                         packedB.data() + panel * blocking::nr * depth);
+                        }
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp for schedule(runtime)
+#endif
+                        for (size_t block = 0; block < rowBlocks; ++block) {
+                            const size_t ic = block * blocking::mc;
+                            const size_t rows = std::min(blocking::mc, m - ic);
+                            gemmPackA<T, Alloc, regType>(a, ic, rows, pc, depth, packedA.data());
+
+                            for (size_t panel = 0; panel < panels; ++panel) {
+                                const size_t jr = panel * blocking::nr;
+                                const T *bp = packedB.data() + jr * depth;
+
+                                for (size_t ir = 0; ir < rows; ir += blocking::mr) {
+                                    gemmKernel<T, regType>(depth, packedA.data() + ir * depth, bp,
+                                                           c[ic + ir] + jc + jr, c.dcols(),
+                                                           std::min(blocking::mr, rows - ir),
+                                                           std::min(blocking::nr, cols - jr),
+                                                           accumulate);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // In-copy implementation c=a*b for floating point types
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<std::is_same<T, double>::value ||
+                                        std::is_same<T, float>::value, int>::type = 0>
+        inline void multiplicate(const Matrix <T, Alloc> &a,
+                                 const Matrix <T, Alloc> &b,
+                                 Matrix <T, Alloc> &c,
+                                 const ParallelOptions &parallel = ParallelOptions()) {
+
+            //Se verifica que las matrices sean compatibles para
+            //realizar la multiplicacion
+            if (a.cols() != b.rows()) {
+                throw anpi::Exception("Las dimensiones de las matrices no son compatibles");
+            }
+
+            assert((&c != &a) && (&c != &b));
+
+#ifdef __AVX512F__
+            multiplicateSIMD<T, Alloc, typename avx512_traits<T>::reg_type>(a, b, c, parallel);
+#elif  __AVX__
+            multiplicateSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a, b, c, parallel);
+#else
+            ::anpi::fallback::multiplicate(a, b, c);
+#endif
+        }
+
+        // Other types
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<!(std::is_same<T, double>::value ||
+                                          std::is_same<T, float>::value), int>::type = 0>
+        inline void multiplicate(const Matrix <T, Alloc> &a,
+                                 const Matrix <T, Alloc> &b,
+                                 Matrix <T, Alloc> &c,
+                                 const ParallelOptions & = ParallelOptions()) {
+            ::anpi::fallback::multiplicate(a, b, c);
+        }
+
+        // In-place implementation a = a*b
         template<typename T, class Alloc>
-        inline void divide(Matrix <T, Alloc> &a,
-                           const Matrix <T, Alloc> &factor) {
+        inline void multiplicate(Matrix <T, Alloc> &a,
+                                 const Matrix <T, Alloc> &b) {
+
+            // The product is copied back, so a keeps its allocator
+            Matrix <T, Alloc> mult(a.resultAllocator());
+            multiplicate(a, b, mult);
+            a = mult;
+        }
+
+
+        /*
+         * Matrix-vector product
+         */
+
+        // Rows or columns of a combined at once by the matrix-vector
+        // products, so each register of the vectors is loaded once for all
+        constexpr size_t gemvRows = 4;
+
+        // Largest segment of y updated by a task of the transposed product,
+        // it stays in the L1 cache while all the rows are added to it
+        constexpr size_t gemvColumns = 1024;
+
+        // Implementation y = a*x. Each task reduces gemvRows rows against x
+        template<typename T, class Alloc, typename regType>
+        inline void multiplicateSIMD(const Matrix <T, Alloc> &a,
+                                     const T *x,
+                                     T *y,
+                                     const ParallelOptions &parallel) {
+
+            constexpr size_t step = sizeof(regType) / sizeof(T);
+
+            const size_t rows = a.rows();
+            const size_t cols = a.cols();
+            const size_t full = cols - cols % step;
+            const size_t groups = (rows + gemvRows - 1) / gemvRows;
+            const int threads = parallel.threadsFor(rows * cols, groups);
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+            for (size_t group = 0; group < groups; ++group) {
+                const size_t i0 = group * gemvRows;
+                const size_t count = std::min(gemvRows, rows - i0);
+
+                // A partial group repeats its last row
+                const T *row[gemvRows];
+                for (size_t r = 0; r < gemvRows; ++r) {
+                    row[r] = a[i0 + std::min(r, count - 1)];
+                }
+
+                regType s0 = mm_set1<T, regType>(T(0)), s1 = s0, s2 = s0, s3 = s0;
+                for (size_t j = 0; j < full; j += step) {
+                    const regType xv = mm_loadRegisteru<T, regType>(x + j);
+                    s0 = mm_fmadd<T>(mm_loadRegisteru<T, regType>(row[0] + j), xv, s0);
+                    s1 = mm_fmadd<T>(mm_loadRegisteru<T, regType>(row[1] + j), xv, s1);
+                    s2 = mm_fmadd<T>(mm_loadRegisteru<T, regType>(row[2] + j), xv, s2);
+                    s3 = mm_fmadd<T>(mm_loadRegisteru<T, regType>(row[3] + j), xv, s3);
+                }
 
-            divide(a, factor, a);
+                alignas(sizeof(regType)) T sums[gemvRows][step];
+                mm_storeRegister<T>(sums[0], s0);
+                mm_storeRegister<T>(sums[1], s1);
+                mm_storeRegister<T>(sums[2], s2);
+                mm_storeRegister<T>(sums[3], s3);
+
+                for (size_t r = 0; r < count; ++r) {
+                    T sum = T(0);
+                    for (size_t k = 0; k < step; ++k) {
+                        sum += sums[r][k];
+                    }
+                    for (size_t j = full; j < cols; ++j) {
+                        sum += row[r][j] * x[j];
+                    }
+                    y[i0 + r] = sum;
+                }
+            }
+        }
+
+        // Implementation y = a^T*x. Each task owns a segment of y and adds
+        // to it the rows of a, gemvRows at a time
+        template<typename T, class Alloc, typename regType>
+        inline void multiplicateTransposedSIMD(const Matrix <T, Alloc> &a,
+                                               const T *x,
+                                               T *y,
+                                               const ParallelOptions &parallel) {
+
+            constexpr size_t step = sizeof(regType) / sizeof(T);
+
+            const size_t rows = a.rows();
+            const size_t cols = a.cols();
+            const size_t fullRows = rows - rows % gemvRows;
+            const int threads = parallel.threadsFor(rows * cols, (cols + step - 1) / step);
+
+            // Segments of whole registers, enough for all the threads
+            const size_t perThread = (cols + size_t(threads) - 1) / size_t(threads);
+            const size_t width = std::max(step, std::min(gemvColumns, (perThread + step - 1) / step * step));
+            const size_t segments = (cols + width - 1) / width;
+
+#ifdef ANPI_ENABLE_OpenMP
+#pragma omp parallel for num_threads(threads) schedule(runtime) if (threads > 1)
+#endif
+            for (size_t segment = 0; segment < segments; ++segment) {
+                const size_t j0 = segment * width;
+                const size_t j1 = std::min(j0 + width, cols);
+                const size_t full = j1 - (j1 - j0) % step;
+
+                std::fill(y + j0, y + j1, T(0));
+
+                size_t i = 0;
+                for (; i < fullRows; i += gemvRows) {
+                    const T *r0 = a[i];
+                    const T *r1 = a[i + 1];
+                    const T *r2 = a[i + 2];
+                    const T *r3 = a[i + 3];
+                    const regType f0 = mm_set1<T, regType>(x[i]);
+                    const regType f1 = mm_set1<T, regType>(x[i + 1]);
+                    const regType f2 = mm_set1<T, regType>(x[i + 2]);
+                    const regType f3 = mm_set1<T, regType>(x[i + 3]);
+
+                    size_t j = j0;
+                    for (; j < full; j += step) {
+                        regType sum = mm_loadRegisteru<T, regType>(y + j);
+                        sum = mm_fmadd<T>(f0, mm_loadRegisteru<T, regType>(r0 + j), sum);
+                        sum = mm_fmadd<T>(f1, mm_loadRegisteru<T, regType>(r1 + j), sum);
+                        sum = mm_fmadd<T>(f2, mm_loadRegisteru<T, regType>(r2 + j), sum);
+                        sum = mm_fmadd<T>(f3, mm_loadRegisteru<T, regType>(r3 + j), sum);
+                        mm_storeRegisteru<T>(y + j, sum);
+                    }
+                    for (; j < j1; ++j) {
+                        y[j] += x[i] * r0[j] + x[i + 1] * r1[j] + x[i + 2] * r2[j] + x[i + 3] * r3[j];
+                    }
+                }
+
+                for (; i < rows; ++i) {
+                    const T *row = a[i];
+                    const regType factor = mm_set1<T, regType>(x[i]);
+
+                    size_t j = j0;
+                    for (; j < full; j += step) {
+                        mm_storeRegisteru<T>(y + j, mm_fmadd<T>(factor, mm_loadRegisteru<T, regType>(row + j),
+                                                                mm_loadRegisteru<T, regType>(y + j)));
+                    }
+                    for (; j < j1; ++j) {
+                        y[j] += x[i] * row[j];
+                    }
+                }
+            }
+        }
+
+        // Matrix-vector products for floating point types
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<std::is_same<T, double>::value ||
+                                        std::is_same<T, float>::value, int>::type = 0>
+        inline void multiplicate(const Matrix <T, Alloc> &a,
+                                 const T *x,
+                                 T *y,
+                                 const ParallelOptions &parallel = ParallelOptions()) {
+#ifdef __AVX512F__
+            multiplicateSIMD<T, Alloc, typename avx512_traits<T>::reg_type>(a, x, y, parallel);
+#elif  __AVX__
+            multiplicateSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a, x, y, parallel);
+#else
+            ::anpi::fallback::multiplicate(a, x, y);
+#endif
+        }
+
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<std::is_same<T, double>::value ||
+                                        std::is_same<T, float>::value, int>::type = 0>
+        inline void multiplicateTransposed(const Matrix <T, Alloc> &a,
+                                           const T *x,
+                                           T *y,
+                                           const ParallelOptions &parallel = ParallelOptions()) {
+#ifdef __AVX512F__
+            multiplicateTransposedSIMD<T, Alloc, typename avx512_traits<T>::reg_type>(a, x, y, parallel);
+#elif  __AVX__
+            multiplicateTransposedSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a, x, y, parallel);
+#else
+            ::anpi::fallback::multiplicateTransposed(a, x, y);
+#endif
+        }
+
+        // Other types
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<!(std::is_same<T, double>::value ||
+                                          std::is_same<T, float>::value), int>::type = 0>
+        inline void multiplicate(const Matrix <T, Alloc> &a,
+                                 const T *x,
+                                 T *y,
+                                 const ParallelOptions & = ParallelOptions()) {
+            ::anpi::fallback::multiplicate(a, x, y);
+        }
+
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<!(std::is_same<T, double>::value ||
+                                          std::is_same<T, float>::value), int>::type = 0>
+        inline void multiplicateTransposed(const Matrix <T, Alloc> &a,
+                                           const T *x,
+                                           T *y,
+                                           const ParallelOptions & = ParallelOptions()) {
+            ::anpi::fallback::multiplicateTransposed(a, x, y);
+        }
+
+
+        /*
+         * Transposition
+         */
+
+        // In-copy implementation c = a^T, the full register blocks are
+        // transposed in registers and the remaining rows and columns one
+        // entry at a time. The loads and stores are unaligned, so any
+        // allocator is supported
+        template<typename T, class Alloc, typename regType>
+        inline void transposeSIMD(const Matrix <T, Alloc> &a,
+                                  Matrix <T, Alloc> &c) {
+
+            assert(&a != &c);
+
+            constexpr size_t step = sizeof(regType) / sizeof(T);
+            constexpr size_t tile = ::anpi::fallback::transposeTile;
+            static_assert(tile % step == 0, "The tile must hold whole register blocks");
+
+            const size_t rows = a.rows();
+            const size_t cols = a.cols();
+            const size_t fullRows = rows - rows % step;
+            const size_t fullCols = cols - cols % step;
+            c.allocate(cols, rows);
+
+            regType block[step];
+
+            for (size_t ib = 0; ib < fullRows; ib += tile) {
+                const size_t iEnd = std::min(ib + tile, fullRows);
+
+                for (size_t jb = 0; jb < fullCols; jb += tile) {
+                    const size_t jEnd = std::min(jb + tile, fullCols);
+
+                    for (size_t i = ib; i < iEnd; i += step) {
+                        for (size_t j = jb; j < jEnd; j += step) {
+                            for (size_t k = 0; k < step; ++k) {
+                                block[k] = mm_loadRegisteru<T, regType>(a[i + k] + j);
+                            }
+                            mm_transpose<T>(block);
+                            for (size_t k = 0; k < step; ++k) {
+                                mm_storeRegisteru<T>(c[j + k] + i, block[k]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Columns left out of the register blocks
+            for (size_t i = 0; i < fullRows; ++i) {
+                const T *src = a[i];
+                for (size_t j = fullCols; j < cols; ++j) {
+                    c[j][i] = src[j];
+                }
+            }
+
+            // Rows left out of the register blocks
+            for (size_t i = fullRows; i < rows; ++i) {
+                const T *src = a[i];
+                for (size_t j = 0; j < cols; ++j) {
+                    c[j][i] = src[j];
+                }
+            }
+        }
+
+        // In-place implementation a = a^T, only for square matrices. The
+        // blocks above the diagonal are swapped with their mirrors below it
+        // while both are held in registers
+        template<typename T, class Alloc, typename regType>
+        inline void transposeSIMD(Matrix <T, Alloc> &a) {
+
+            assert(a.rows() == a.cols());
+
+            constexpr size_t step = sizeof(regType) / sizeof(T);
+            constexpr size_t tile = ::anpi::fallback::transposeTile;
+            static_assert(tile % step == 0, "The tile must hold whole register blocks");
+
+            const size_t n = a.rows();
+            const size_t full = n - n % step;
+
+            regType upper[step];
+            regType lower[step];
+
+            for (size_t ib = 0; ib < full; ib += tile) {
+                const size_t iEnd = std::min(ib + tile, full);
+
+                for (size_t jb = ib; jb < full; jb += tile) {
+                    const size_t jEnd = std::min(jb + tile, full);
+
+                    for (size_t i = ib; i < iEnd; i += step) {
+                        for (size_t j = std::max(jb, i); j < jEnd; j += step) {
+                            for (size_t k = 0; k < step; ++k) {
+                                upper[k] = mm_loadRegisteru<T, regType>(a[i + k] + j);
+                            }
+                            mm_transpose<T>(upper);
+
+                            if (i == j) { // block on the diagonal
+                                for (size_t k = 0; k < step; ++k) {
+                                    mm_storeRegisteru<T>(a[i + k] + j, upper[k]);
+                                }
+                                continue;
+                            }
+
+                            for (size_t k = 0; k < step; ++k) {
+                                lower[k] = mm_loadRegisteru<T, regType>(a[j + k] + i);
+                            }
+                            mm_transpose<T>(lower);
+
+                            for (size_t k = 0; k < step; ++k) {
+                                mm_storeRegisteru<T>(a[j + k] + i, upper[k]);
+                                mm_storeRegisteru<T>(a[i + k] + j, lower[k]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Rows and columns left out of the register blocks
+            for (size_t i = full; i < n; ++i) {
+                T *row = a[i];
+                for (size_t j = 0; j < i; ++j) {
+                    std::swap(row[j], a[j][i]);
+                }
+            }
+        }
+
+        // Transposition for floating point types
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<std::is_same<T, double>::value ||
+                                        std::is_same<T, float>::value, int>::type = 0>
+        inline void transpose(const Matrix <T, Alloc> &a,
+                              Matrix <T, Alloc> &c) {
+#ifdef __AVX__
+            transposeSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a, c);
+#else
+            ::anpi::fallback::transpose(a, c);
+#endif
+        }
+
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<std::is_same<T, double>::value ||
+                                        std::is_same<T, float>::value, int>::type = 0>
+        inline void transpose(Matrix <T, Alloc> &a) {
+#ifdef __AVX__
+            transposeSIMD<T, Alloc, typename avx_traits<T>::reg_type>(a);
+#else
+            ::anpi::fallback::transpose(a);
+#endif
+        }
+
+        // Other types
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<!(std::is_same<T, double>::value ||
+                                          std::is_same<T, float>::value), int>::type = 0>
+        inline void transpose(const Matrix <T, Alloc> &a,
+                              Matrix <T, Alloc> &c) {
+            ::anpi::fallback::transpose(a, c);
+        }
+
+        template<typename T,
+                class Alloc,
+                typename std::enable_if<!(std::is_same<T, double>::value ||
+                                          std::is_same<T, float>::value), int>::type = 0>
+        inline void transpose(Matrix <T, Alloc> &a) {
+            ::anpi::fallback::transpose(a);
         }
 
 
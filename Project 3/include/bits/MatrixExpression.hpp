@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date:   17.10.2026
+ */
+
+#ifndef ANPI_MATRIX_EXPRESSION_HPP
+#define ANPI_MATRIX_EXPRESSION_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#include "Intrinsics.hpp"
+#include "IntrinsicsMethods.hpp"
+#include "Exception.hpp"
+
+namespace anpi {
+
+    template<typename T, class Alloc>
+    class Matrix;
+
+    /**
+     * Lazy element-wise expressions of matrices.
+     *
+     * The sums, differences, scalar products and scalar quotients of
+     * matrices build a tree of expressions instead of a matrix. The tree is
+     * evaluated when it is assigned to a matrix, one entry or one register
+     * of entries at a time, so a chain like lambda*a + (1-lambda)*b is
+     * computed in a single pass without temporary matrices.
+     *
+     * The expressions refer to the matrices of their leaves, which must
+     * outlive them: an expression is meant to be assigned in the statement
+     * that builds it, and not to be kept with auto.
+     */
+    namespace expr {
+
+        /**
+         * Base of all the expressions
+         *
+         * @tparam E    :   Type of the expression
+         */
+        template<class E>
+        struct Expression {
+            /// The expression itself
+            inline const E &self() const {
+                return static_cast<const E &>(*this);
+            }
+        };
+
+
+        /**
+         * Leaf that reads a matrix
+         *
+         * @tparam T        :   Data type
+         * @tparam Alloc    :   Allocator of the matrix
+         */
+        template<typename T, class Alloc>
+        class MatrixLeaf : public Expression<MatrixLeaf<T, Alloc> > {
+        public:
+            typedef T value_type;
+            typedef Alloc allocator_type;
+
+            explicit MatrixLeaf(const Matrix<T, Alloc> &m) : _m(m) {}
+
+            inline size_t rows() const { return _m.rows(); }
+
+            inline size_t cols() const { return _m.cols(); }
+
+            /// Entry at the row i and the column j
+            inline T entry(const size_t i, const size_t j) const {
+                return _m[i][j];
+            }
+
+            /// Entries of a register starting at the row i and the column j
+            template<typename regType>
+            inline regType load(const size_t i, const size_t j) const {
+                return mm_loadRegisteru<T, regType>(_m[i] + j);
+            }
+
+            /// Allocator for a matrix that evaluates the expression
+            inline Alloc resultAllocator() const {
+                return _m.resultAllocator();
+            }
+
+        private:
+            const Matrix<T, Alloc> &_m;
+        };
+
+
+        /// Element-wise sum
+        struct AddOp {
+            template<typename T>
+            static inline T apply(const T a, const T b) { return a + b; }
+
+            template<typename T, typename regType>
+            static inline regType applyRegister(const regType a, const regType b) { return mm_add<T>(a, b); }
+        };
+
+        /// Element-wise difference
+        struct SubtractOp {
+            template<typename T>
+            static inline T apply(const T a, const T b) { return a - b; }
+
+            template<typename T, typename regType>
+            static inline regType applyRegister(const regType a, const regType b) { return mm_sub<T>(a, b); }
+        };
+
+
+        /**
+         * Element-wise operation of two expressions of the same size
+         *
+         * @tparam L    :   Left operand
+         * @tparam R    :   Right operand
+         * @tparam Op   :   Operation, AddOp or SubtractOp
+         */
+        template<class L, class R, class Op>
+        class Binary : public Expression<Binary<L, R, Op> > {
+        public:
+            typedef typename L::value_type value_type;
+            typedef typename L::allocator_type allocator_type;
+
+            static_assert(std::is_same<value_type, typename R::value_type>::value,
+                          "The operands must have the same data type");
+
+            Binary(const L &left, const R &right) : _left(left), _right(right) {
+                assert((left.rows() == right.rows()) && (left.cols() == right.cols()));
+            }
+
+            inline size_t rows() const { return _left.rows(); }
+
+            inline size_t cols() const { return _left.cols(); }
+
+            inline value_type entry(const size_t i, const size_t j) const {
+                return Op::apply(_left.entry(i, j), _right.entry(i, j));
+            }
+
+            template<typename regType>
+            inline regType load(const size_t i, const size_t j) const {
+                return Op::template applyRegister<value_type, regType>(_left.template load<regType>(i, j),
+                                                                       _right.template load<regType>(i, j));
+            }
+
+            inline allocator_type resultAllocator() const {
+                return _left.resultAllocator();
+            }
+
+        private:
+            const L _left;
+            const R _right;
+        };
+
+
+        /**
+         * Expression multiplied by a scalar
+         *
+         * @tparam E    :   Scaled expression
+         */
+        template<class E>
+        class Scaled : public Expression<Scaled<E> > {
+        public:
+            typedef typename E::value_type value_type;
+            typedef typename E::allocator_type allocator_type;
+
+            Scaled(const value_type factor, const E &operand) : _factor(factor), _operand(operand) {}
+
+            inline size_t rows() const { return _operand.rows(); }
+
+            inline size_t cols() const { return _operand.cols(); }
+
+            inline value_type entry(const size_t i, const size_t j) const {
+                return _factor * _operand.entry(i, j);
+            }
+
+            template<typename regType>
+            inline regType load(const size_t i, const size_t j) const {
+                return mm_mult<value_type>(mm_set1<value_type, regType>(_factor),
+                                           _operand.template load<regType>(i, j));
+            }
+
+            inline allocator_type resultAllocator() const {
+                return _operand.resultAllocator();
+            }
+
+        private:
+            const value_type _factor;
+            const E _operand;
+        };
+
+
+        /**
+         * Expression divided by a scalar. Each entry is divided, instead of
+         * multiplied by the inverse, so the results are exact as in a loop
+         *
+         * @tparam E    :   Divided expression
+         */
+        template<class E>
+        class Divided : public Expression<Divided<E> > {
+        public:
+            typedef typename E::value_type value_type;
+            typedef typename E::allocator_type allocator_type;
+
+            Divided(const E &operand, const value_type factor) : _operand(operand), _factor(factor) {}
+
+            inline size_t rows() const { return _operand.rows(); }
+
+            inline size_t cols() const { return _operand.cols(); }
+
+            inline value_type entry(const size_t i, const size_t j) const {
+                return _operand.entry(i, j) / _factor;
+            }
+
+            template<typename regType>
+            inline regType load(const size_t i, const size_t j) const {
+                return mm_div<value_type>(_operand.template load<regType>(i, j),
+                                          mm_set1<value_type, regType>(_factor));
+            }
+
+            inline allocator_type resultAllocator() const {
+                return _operand.resultAllocator();
+            }
+
+        private:
+            const E _operand;
+            const value_type _factor;
+        };
+
+
+        /**
+         * Allocator for a matrix that evaluates the expression: the result
+         * allocator of its first leaf, or a default one if the matrix has
+         * another type of allocator
+         *
+         * @tparam Alloc    :   Allocator of the matrix
+         * @tparam E        :   Type of the expression
+         */
+        template<class Alloc, class E>
+        inline Alloc resultAllocator(const E &e, std::true_type) {
+            return e.resultAllocator();
+        }
+
+        template<class Alloc, class E>
+        inline Alloc resultAllocator(const E &, std::false_type) {
+            return Alloc();
+        }
+
+        template<class Alloc, class E>
+        inline Alloc resultAllocator(const E &e) {
+            return resultAllocator<Alloc>(e, std::is_same<typename E::allocator_type, Alloc>());
+        }
+
+
+        /**
+         * Operands of the expressions: matrices are wrapped as leaves and
+         * expressions are kept as they are
+         */
+        template<class E, typename Enable = void>
+        struct operand {
+            static constexpr bool value = false;
+        };
+
+        template<class E>
+        struct operand<E, typename std::enable_if<std::is_base_of<Expression<E>, E>::value>::type> {
+            static constexpr bool value = true;
+            static constexpr bool expression = true;
+            typedef E type;
+
+            static inline const E &wrap(const E &e) { return e; }
+        };
+
+        template<typename T, class Alloc>
+        struct operand<Matrix<T, Alloc>, void> {
+            static constexpr bool value = true;
+            static constexpr bool expression = false;
+            typedef MatrixLeaf<T, Alloc> type;
+
+            static inline type wrap(const Matrix<T, Alloc> &m) { return type(m); }
+        };
+
+        /// Both types are operands
+        template<class L, class R>
+        struct operands {
+            static constexpr bool value = operand<L>::value && operand<R>::value;
+        };
+
+
+        /// Lazy sum of matrices or expressions
+        template<class L, class R,
+                typename std::enable_if<operands<L, R>::value, int>::type = 0>
+        inline Binary<typename operand<L>::type, typename operand<R>::type, AddOp>
+        operator+(const L &a, const R &b) {
+            return Binary<typename operand<L>::type, typename operand<R>::type, AddOp>(operand<L>::wrap(a),
+                                                                                      operand<R>::wrap(b));
+        }
+
+        /// Lazy difference of matrices or expressions
+        template<class L, class R,
+                typename std::enable_if<operands<L, R>::value, int>::type = 0>
+        inline Binary<typename operand<L>::type, typename operand<R>::type, SubtractOp>
+        operator-(const L &a, const R &b) {
+            return Binary<typename operand<L>::type, typename operand<R>::type, SubtractOp>(operand<L>::wrap(a),
+                                                                                           operand<R>::wrap(b));
+        }
+
+        /// Lazy product of a scalar and a matrix or expression
+        template<typename U, class E,
+                typename std::enable_if<std::is_arithmetic<U>::value && operand<E>::value, int>::type = 0>
+        inline Scaled<typename operand<E>::type>
+        operator*(const U factor, const E &e) {
+            typedef typename operand<E>::type::value_type T;
+            return Scaled<typename operand<E>::type>(T(factor), operand<E>::wrap(e));
+        }
+
+        template<class E, typename U,
+                typename std::enable_if<std::is_arithmetic<U>::value && operand<E>::value, int>::type = 0>
+        inline Scaled<typename operand<E>::type>
+        operator*(const E &e, const U factor) {
+            return factor * e;
+        }
+
+
+        /// Lazy quotient of a matrix or expression and a scalar
+        template<class E, typename U,
+                typename std::enable_if<std::is_arithmetic<U>::value && operand<E>::value, int>::type = 0>
+        inline Divided<typename operand<E>::type>
+        operator/(const E &e, const U factor) {
+            typedef typename operand<E>::type::value_type T;
+
+            if (factor == U(0)) {
+                throw anpi::Exception("Se intentó dividir todos los elementos de la matriz por cero");
+            }
+
+            return Divided<typename operand<E>::type>(operand<E>::wrap(e), T(factor));
+        }
+
+
+        /// Entry-wise comparison, for operands where at least one is an expression
+        template<class L, class R,
+                typename std::enable_if<operands<L, R>::value &&
+                                        (operand<L>::expression || operand<R>::expression), int>::type = 0>
+        inline bool operator==(const L &a, const R &b) {
+            const typename operand<L>::type left = operand<L>::wrap(a);
+            const typename operand<R>::type right = operand<R>::wrap(b);
+
+            if ((left.rows() != right.rows()) || (left.cols() != right.cols())) {
+                return false;
+            }
+
+            for (size_t i = 0; i < left.rows(); ++i) {
+                for (size_t j = 0; j < left.cols(); ++j) {
+                    if (left.entry(i, j) != right.entry(i, j)) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        template<class L, class R,
+                typename std::enable_if<operands<L, R>::value &&
+                                        (operand<L>::expression || operand<R>::expression), int>::type = 0>
+        inline bool operator!=(const L &a, const R &b) {
+            return !(a == b);
+        }
+
+    } // namespace expr
+
+    // The operators of the expressions apply to matrices as well
+    using expr::operator+;
+    using expr::operator-;
+    using expr::operator*;
+    using expr::operator/;
+    using expr::operator==;
+    using expr::operator!=;
+
+} // namespace anpi
+
+#endif
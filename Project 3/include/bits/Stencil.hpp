@@ -0,0 +1,645 @@
+/*
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, ITCR, Costa Rica
+ *
+ * This file is part of the numerical analysis lecture CE3102 at TEC
+ *
+ * @Date:   17.10.2026
+ */
+
+#ifndef ANPI_STENCIL_HPP
+#define ANPI_STENCIL_HPP
+
+#include "Intrinsics.hpp"
+#include <type_traits>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Matrix.hpp"
+#include "Allocator.hpp"
+#include "IntrinsicsMethods.hpp"
+#include "HalfPrecision.hpp"
+
+namespace anpi {
+
+    /**
+     * Weights of the four neighbours of a pixel in the 5-point stencil,
+     * the 1/4 factor of the mean is already included
+     *
+     * @tparam T    :   Data type
+     */
+    template<typename T>
+    struct StencilWeights {
+        T up, down, left, right;
+    };
+
+
+    /**
+     * Norms of the change of the pixels on a sweep, accumulated while the
+     * sweep is computed
+     *
+     * @tparam T    :   Data type
+     */
+    template<typename T>
+    struct UpdateNorms {
+        /// Largest absolute change of a pixel
+        T max = T(0);
+
+        /// Sum of the squared changes
+        T squares = T(0);
+
+        /// Number of pixels measured
+        size_t count = 0;
+
+        /// Accumulates the norms of another part of the plate
+        inline UpdateNorms<T> &operator+=(const UpdateNorms<T> &other) {
+            max = std::max(max, other.max);
+            squares += other.squares;
+            count += other.count;
+            return *this;
+        }
+    };
+
+
+    /// Isolation pattern of a stencil whose weights are only known at run time
+    constexpr unsigned AnyIsolation = 16;
+
+    /**
+     * Reads of each neighbour made by the stencil of an isolation pattern,
+     * known at compile time. An isolated border makes the pixel reuse the
+     * opposite neighbour, so each neighbour is read 0, 1 or 2 times with a
+     * weight of 1/4, and both neighbours of a direction add up to 2 reads.
+     *
+     * @tparam Pattern  :   Bitmask of the isolated borders {top = 1; bot = 2; left = 4; right = 8},
+     *                      AnyIsolation to use the weights given at run time
+     */
+    template<unsigned Pattern>
+    struct IsolationPattern {
+        static constexpr bool generic = Pattern >= AnyIsolation;
+        static constexpr int up = int((Pattern & 1u) == 0) + int((Pattern & 2u) != 0);
+        static constexpr int down = 2 - up;
+        static constexpr int left = int((Pattern & 4u) == 0) + int((Pattern & 8u) != 0);
+        static constexpr int right = 2 - left;
+    };
+
+
+    /**
+     * Finds the isolation pattern with the given stencil weights. Isolating
+     * both borders of a direction gives the same weights as isolating none,
+     * so the pattern found only has the bits of the directions with a single
+     * isolated border.
+     *
+     * @tparam T        :   Data type
+     * @param weights   :   Weights of the neighbours {up; down; left; right}
+     * @return          :   Bitmask of the isolated borders, AnyIsolation if the weights do not belong to a pattern
+     */
+    template<typename T>
+    unsigned isolationPattern(const StencilWeights<T> &weights) {
+
+        // Number of 1/4 weighted reads of a neighbour, -1 if it is not whole
+        const auto reads = [](const T weight) -> int {
+            return (weight == T(0)) ? 0 : (weight == T(0.25)) ? 1 : (weight == T(0.5)) ? 2 : -1;
+        };
+
+        const int up = reads(weights.up);
+        const int down = reads(weights.down);
+        const int left = reads(weights.left);
+        const int right = reads(weights.right);
+
+        if (up < 0 || down < 0 || left < 0 || right < 0 || up + down != 2 || left + right != 2) {
+            return AnyIsolation;
+        }
+
+        return unsigned(up == 0) | (unsigned(down == 0) << 1) | (unsigned(left == 0) << 2) | (unsigned(right == 0) << 3);
+    }
+
+
+    /**
+     * Calls function with the isolation pattern as a compile time constant,
+     * std::integral_constant<unsigned, Pattern>, so the kernels called from
+     * it are instantiated once per pattern. A direction with both borders
+     * isolated is dispatched as a direction without isolation, they have the
+     * same stencil, so the sixteen patterns need nine instantiations.
+     *
+     * @param pattern   :   Bitmask of the isolated borders, or AnyIsolation
+     * @param function  :   Generic callable taking the pattern constant
+     * @return          :   The value returned by function
+     */
+    template<class Function>
+    inline auto dispatchIsolation(unsigned pattern, Function &&function)
+    -> decltype(function(std::integral_constant<unsigned, AnyIsolation>())) {
+
+        if (pattern < AnyIsolation) {
+            if ((pattern & 3u) == 3u) pattern &= ~3u;
+            if ((pattern & 12u) == 12u) pattern &= ~12u;
+        }
+
+        switch (pattern) {
+            case 0: return function(std::integral_constant<unsigned, 0>());
+            case 1: return function(std::integral_constant<unsigned, 1>());
+            case 2: return function(std::integral_constant<unsigned, 2>());
+            case 4: return function(std::integral_constant<unsigned, 4>());
+            case 5: return function(std::integral_constant<unsigned, 5>());
+            case 6: return function(std::integral_constant<unsigned, 6>());
+            case 8: return function(std::integral_constant<unsigned, 8>());
+            case 9: return function(std::integral_constant<unsigned, 9>());
+            case 10: return function(std::integral_constant<unsigned, 10>());
+            default: return function(std::integral_constant<unsigned, AnyIsolation>());
+        }
+    }
+
+
+    /**
+     * Sum of the reads of a pair of opposite neighbours, a is read First
+     * times and b the remaining 2 - First times
+     */
+    template<int First, typename T>
+    inline T pairSum(const T a, const T b) {
+        return (First == 1) ? a + b : (First == 2) ? a + a : b + b;
+    }
+
+
+    namespace fallback {
+
+        /*
+         * Relaxed 5-point stencil on one row: out = lambda * stencil(in) + (1 - lambda) * in
+         */
+
+        // Fallback implementation, the border columns are not written
+        template<bool Measure, unsigned Pattern, typename T, class Alloc>
+        inline UpdateNorms<compute_t<T> > stencilRowImpl(Matrix <T, Alloc> &out,
+                                                         const Matrix <T, Alloc> &in,
+                                                         const size_t i,
+                                                         const StencilWeights<compute_t<T> > &weights,
+                                                         const compute_t<T> lambda) {
+
+            assert((out.rows() == in.rows()) &&
+                   (out.cols() == in.cols()) &&
+                   (i > 0) && (i + 1 < in.rows()));
+
+            const size_t cols = in.cols();
+            const T *up = in[i - 1];
+            const T *row = in[i];
+            const T *down = in[i + 1];
+            T *here = out[i];
+
+            // Storage types of 16 bits are operated in float
+            typedef compute_t<T> C;
+
+            // The weights are scaled once, so the loop does not branch on the isolation
+            const C wUp = lambda * weights.up;
+            const C wDown = lambda * weights.down;
+            const C wLeft = lambda * weights.left;
+            const C wRight = lambda * weights.right;
+            const C keep = C(1) - lambda;
+
+            // A known pattern adds the reads of the neighbours and scales them once
+            typedef IsolationPattern<Pattern> P;
+            const C quarter = lambda / C(4);
+
+            UpdateNorms<C> norms;
+
+            for (size_t j = 1; j < cols - 1; ++j) {
+                if (P::generic) {
+                    here[j] = wUp * C(up[j]) + wDown * C(down[j]) + wLeft * C(row[j - 1]) +
+                              wRight * C(row[j + 1]) + keep * C(row[j]);
+                } else {
+                    here[j] = quarter * (pairSum<P::up, C>(up[j], down[j]) +
+                                         pairSum<P::left, C>(row[j - 1], row[j + 1])) +
+                              keep * C(row[j]);
+                }
+
+                if (Measure) {
+                    const C change = C(here[j]) - C(row[j]);
+                    norms.max = std::max(norms.max, C(std::abs(change)));
+                    norms.squares += change * change;
+                }
+            }
+
+            norms.count = Measure ? cols - 2 : 0;
+            return norms;
+        }
+
+        // The weights must be the ones of Pattern unless it is AnyIsolation
+        template<unsigned Pattern = AnyIsolation, typename T, class Alloc>
+        inline void stencilRow(Matrix <T, Alloc> &out,
+                               const Matrix <T, Alloc> &in,
+                               const size_t i,
+                               const StencilWeights<compute_t<T> > &weights,
+                               const compute_t<T> lambda) {
+
+            stencilRowImpl<false, Pattern>(out, in, i, weights, lambda);
+        }
+
+        // Same stencil, also returns the norms of the change of the row
+        template<unsigned Pattern = AnyIsolation, typename T, class Alloc>
+        inline UpdateNorms<compute_t<T> > stencilRowNorms(Matrix <T, Alloc> &out,
+                                                          const Matrix <T, Alloc> &in,
+                                                          const size_t i,
+                                                          const StencilWeights<compute_t<T> > &weights,
+                                                          const compute_t<T> lambda) {
+
+            return stencilRowImpl<true, Pattern>(out, in, i, weights, lambda);
+        }
+
+
+        /*
+         * Relaxed red-black update of the pixels of one color on one row:
+         * u += omega * (stencil(u) - u), in place
+         */
+
+        // Fallback implementation, the norms count no pixels
+        template<unsigned Pattern, typename T, class Alloc>
+        inline UpdateNorms<T> redBlackRow(Matrix <T, Alloc> &plate,
+                                          const size_t i,
+                                          const size_t color,
+                                          const StencilWeights<T> &weights,
+                                          const T omega) {
+
+            assert((i > 0) && (i + 1 < plate.rows()));
+
+            typedef IsolationPattern<Pattern> P;
+
+            const size_t cols = plate.cols();
+            T *row = plate[i];
+            const T *up = plate[i - 1];
+            const T *down = plate[i + 1];
+
+            UpdateNorms<T> norms;
+
+            // First column of the row holding the current color
+            for (size_t j = 1 + ((i + 1 + color) & 1); j < cols - 1; j += 2) {
+
+                const T neighbours = P::generic ?
+                               weights.up * up[j] + weights.down * down[j] +
+                               weights.left * row[j - 1] + weights.right * row[j + 1] :
+                               T(0.25) * (pairSum<P::up>(up[j], down[j]) +
+                                          pairSum<P::left>(row[j - 1], row[j + 1]));
+
+                const T update = omega * (neighbours - row[j]);
+                row[j] += update;
+                norms.max = std::max(norms.max, T(std::abs(update)));
+                norms.squares += update * update;
+            }
+
+            return norms;
+        }
+
+    } // namespace fallback
+
+
+    namespace simd {
+
+        // Relaxed 5-point stencil on one aligned row
+        template<bool Measure, unsigned Pattern, typename T, class Alloc, typename regType>
+        inline UpdateNorms<compute_t<T> > stencilRowSIMD(Matrix <T, Alloc> &out,
+                                                         const Matrix <T, Alloc> &in,
+                                                         const size_t i,
+                                                         const StencilWeights<compute_t<T> > &weights,
+                                                         const compute_t<T> lambda) {
+
+            // This method is instantiated with unaligned allocators.  We
+            // allow the instantiation although externally this is never
+            // called unaligned
+            static_assert(!extract_alignment<Alloc>::aligned ||
+                          (extract_alignment<Alloc>::value >= sizeof(regType)),
+                          "Insufficient alignment for the registers used");
+
+            // Storage types of 16 bits are loaded into float registers
+            typedef compute_t<T> C;
+
+            const size_t cols = in.cols();
+            const size_t step = sizeof(regType) / sizeof(C);
+            const size_t blocks = (cols - 1 + step - 1) / step;
+            const T *up = in[i - 1];
+            const T *row = in[i];
+            const T *down = in[i + 1];
+            T *here = out[i];
+
+            const regType wUp = mm_set1<C, regType>(lambda * weights.up);
+            const regType wDown = mm_set1<C, regType>(lambda * weights.down);
+            const regType wLeft = mm_set1<C, regType>(lambda * weights.left);
+            const regType wRight = mm_set1<C, regType>(lambda * weights.right);
+            const regType keep = mm_set1<C, regType>(C(1) - lambda);
+
+            // A known pattern adds the reads of the neighbours and scales them once
+            typedef IsolationPattern<Pattern> P;
+            const regType quarter = mm_set1<C, regType>(lambda / C(4));
+
+            const regType zero = mm_set1<C, regType>(C(0));
+            regType maxChange = zero;
+            regType squares = zero;
+
+            // The blocks start on the aligned first column and cover the
+            // padding of the row. The shifted loads of the first and last
+            // blocks touch the padding of the previous row and the first
+            // entry of the next one, both inside the allocation because the
+            // row is never the first nor the last of the matrix.
+            for (size_t b = 0; b < blocks; ++b) {
+                const size_t j = b * step;
+                const regType center = mm_loadRegister<T, regType>(row + j);
+
+                regType value;
+
+                if (P::generic) {
+                    value = mm_mult<C>(wUp, mm_loadRegister<T, regType>(up + j));
+                    value = mm_add<C>(value, mm_mult<C>(wDown, mm_loadRegister<T, regType>(down + j)));
+                    value = mm_add<C>(value, mm_mult<C>(wLeft, mm_loadRegisteru<T, regType>(row + j - 1)));
+                    value = mm_add<C>(value, mm_mult<C>(wRight, mm_loadRegisteru<T, regType>(row + j + 1)));
+                } else {
+                    // The neighbours that are not read are never loaded
+                    const regType vertical =
+                            (P::up == 1) ? mm_add<C>(mm_loadRegister<T, regType>(up + j),
+                                                     mm_loadRegister<T, regType>(down + j)) :
+                            (P::up == 2) ? mm_add<C>(mm_loadRegister<T, regType>(up + j),
+                                                     mm_loadRegister<T, regType>(up + j)) :
+                            mm_add<C>(mm_loadRegister<T, regType>(down + j),
+                                      mm_loadRegister<T, regType>(down + j));
+                    const regType horizontal =
+                            (P::left == 1) ? mm_add<C>(mm_loadRegisteru<T, regType>(row + j - 1),
+                                                       mm_loadRegisteru<T, regType>(row + j + 1)) :
+                            (P::left == 2) ? mm_add<C>(mm_loadRegisteru<T, regType>(row + j - 1),
+                                                       mm_loadRegisteru<T, regType>(row + j - 1)) :
+                            mm_add<C>(mm_loadRegisteru<T, regType>(row + j + 1),
+                                      mm_loadRegisteru<T, regType>(row + j + 1));
+                    value = mm_mult<C>(quarter, mm_add<C>(vertical, horizontal));
+                }
+                value = mm_add<C>(value, mm_mult<C>(keep, center));
+
+                mm_storeRegister<T>(here + j, value);
+
+                // The first and last blocks hold border columns and padding,
+                // they are measured below once the borders are restored
+                if (Measure && (b > 0) && (b + 1 < blocks)) {
+                    const regType change = mm_sub<C>(value, center);
+                    maxChange = mm_max<C>(maxChange, mm_max<C>(change, mm_sub<C>(zero, change)));
+                    squares = mm_add<C>(squares, mm_mult<C>(change, change));
+                }
+            }
+
+            // The first and last blocks overwrote the border columns
+            here[0] = row[0];
+            here[cols - 1] = row[cols - 1];
+
+            UpdateNorms<C> norms;
+
+            if (Measure) {
+                alignas(sizeof(regType)) C lanes[2][sizeof(regType) / sizeof(C)];
+                *reinterpret_cast<regType *>(lanes[0]) = maxChange;
+                *reinterpret_cast<regType *>(lanes[1]) = squares;
+
+                for (size_t k = 0; k < step; ++k) {
+                    norms.max = std::max(norms.max, lanes[0][k]);
+                    norms.squares += lanes[1][k];
+                }
+
+                // Inner pixels of the first and last blocks
+                const size_t firstEnd = std::min(step, cols - 1);
+                const size_t lastStart = std::max(firstEnd, (blocks - 1) * step);
+                for (size_t j = 1; j < cols - 1; j = (j + 1 == firstEnd) ? lastStart : j + 1) {
+                    const C change = C(here[j]) - C(row[j]);
+                    norms.max = std::max(norms.max, C(std::abs(change)));
+                    norms.squares += change * change;
+                }
+
+                norms.count = cols - 2;
+            }
+
+            return norms;
+        }
+
+
+        // Relaxed 5-point stencil for the types the SIMD helpers load and store
+        template<bool Measure,
+                unsigned Pattern,
+                typename T,
+                class Alloc,
+                typename std::enable_if<is_simd_storage<T>::value, int>::type = 0>
+        inline UpdateNorms<compute_t<T> > stencilRowImpl(Matrix <T, Alloc> &out,
+                                                         const Matrix <T, Alloc> &in,
+                                                         const size_t i,
+                                                         const StencilWeights<compute_t<T> > &weights,
+                                                         const compute_t<T> lambda) {
+
+            assert((out.rows() == in.rows()) &&
+                   (out.cols() == in.cols()) &&
+                   (i > 0) && (i + 1 < in.rows()));
+
+
+            if (extract_alignment<Alloc>::row_aligned) {
+#ifdef __AVX512F__
+                return stencilRowSIMD<Measure, Pattern, T, Alloc, typename avx512_traits<T>::reg_type>(out, in, i,
+                                                                                                       weights, lambda);
+#elif  __AVX__
+                return stencilRowSIMD<Measure, Pattern, T, Alloc, typename avx_traits<T>::reg_type>(out, in, i,
+                                                                                                    weights, lambda);
+#else
+                return ::anpi::fallback::stencilRowImpl<Measure, Pattern>(out, in, i, weights, lambda);
+#endif
+            } else { // rows do not start on a register boundary
+                return ::anpi::fallback::stencilRowImpl<Measure, Pattern>(out, in, i, weights, lambda);
+            }
+        }
+
+        // Other types
+        template<bool Measure,
+                unsigned Pattern,
+                typename T,
+                class Alloc,
+                typename std::enable_if<!is_simd_storage<T>::value, int>::type = 0>
+        inline UpdateNorms<compute_t<T> > stencilRowImpl(Matrix <T, Alloc> &out,
+                                                         const Matrix <T, Alloc> &in,
+                                                         const size_t i,
+                                                         const StencilWeights<compute_t<T> > &weights,
+                                                         const compute_t<T> lambda) {
+
+            return ::anpi::fallback::stencilRowImpl<Measure, Pattern>(out, in, i, weights, lambda);
+        }
+
+        // The weights must be the ones of Pattern unless it is AnyIsolation
+        template<unsigned Pattern = AnyIsolation, typename T, class Alloc>
+        inline void stencilRow(Matrix <T, Alloc> &out,
+                               const Matrix <T, Alloc> &in,
+                               const size_t i,
+                               const StencilWeights<compute_t<T> > &weights,
+                               const compute_t<T> lambda) {
+
+            stencilRowImpl<false, Pattern>(out, in, i, weights, lambda);
+        }
+
+        // Same stencil, also returns the norms of the change of the row
+        template<unsigned Pattern = AnyIsolation, typename T, class Alloc>
+        inline UpdateNorms<compute_t<T> > stencilRowNorms(Matrix <T, Alloc> &out,
+                                                          const Matrix <T, Alloc> &in,
+                                                          const size_t i,
+                                                          const StencilWeights<compute_t<T> > &weights,
+                                                          const compute_t<T> lambda) {
+
+            return stencilRowImpl<true, Pattern>(out, in, i, weights, lambda);
+        }
+
+
+        // Red-black update of one aligned row. The whole row is computed in
+        // registers, but only the lanes of the current color are read from
+        // the rows above and below and stored back. Those rows are updated
+        // by other threads on the same half sweep, and only their lanes of
+        // the other color stay untouched.
+        template<unsigned Pattern, typename T, class Alloc, typename regType>
+        inline UpdateNorms<T> redBlackRowSIMD(Matrix <T, Alloc> &plate,
+                                              const size_t i,
+                                              const size_t color,
+                                              const StencilWeights<T> &weights,
+                                              const T omega) {
+
+            static_assert(!extract_alignment<Alloc>::aligned ||
+                          (extract_alignment<Alloc>::value >= sizeof(regType)),
+                          "Insufficient alignment for the registers used");
+
+            typedef IsolationPattern<Pattern> P;
+            constexpr size_t step = sizeof(regType) / sizeof(T);
+
+            const size_t cols = plate.cols();
+            const size_t blocks = (cols - 1 + step - 1) / step;
+            T *row = plate[i];
+            const T *up = plate[i - 1];
+            const T *down = plate[i + 1];
+
+            // Lanes of the current color, every block starts on an even column
+            const size_t parity = (i + color) & 1;
+            alignas(sizeof(regType)) T lanes[step];
+            const auto laneMask = [&](const size_t j) -> regType {
+                for (size_t l = 0; l < step; ++l) {
+                    const bool inner = (j + l >= 1) && (j + l + 1 < cols);
+                    std::memset(&lanes[l], (inner && ((l & 1) == parity)) ? 0xFF : 0, sizeof(T));
+                }
+                return mm_loadRegister<T, regType>(lanes);
+            };
+
+            const regType wUp = mm_set1<T, regType>(weights.up);
+            const regType wDown = mm_set1<T, regType>(weights.down);
+            const regType wLeft = mm_set1<T, regType>(weights.left);
+            const regType wRight = mm_set1<T, regType>(weights.right);
+            const regType quarter = mm_set1<T, regType>(T(0.25));
+            const regType relax = mm_set1<T, regType>(omega);
+            const regType zero = mm_set1<T, regType>(T(0));
+            const regType inner = laneMask(step);
+            regType maxChange = zero;
+            regType squares = zero;
+
+            // Each block is stored after the loads of the next one, otherwise
+            // the shifted load of the next block would wait for the store
+            regType pending = zero;
+            regType pendingMask = zero;
+
+            // The shifted loads of the first and last blocks touch the padding
+            // of the previous row and the first entry of the next one, both
+            // inside the allocation because the row is never the first nor
+            // the last of the matrix
+            for (size_t b = 0; b < blocks; ++b) {
+                const size_t j = b * step;
+                const regType center = mm_loadRegister<T, regType>(row + j);
+                regType neighbours;
+
+                // Only the first and last blocks hold border columns or padding
+                const regType mask = (b > 0 && b + 1 < blocks) ? inner : laneMask(j);
+
+                if (P::generic) {
+                    neighbours = mm_mult<T>(wUp, mm_maskLoadRegister<T>(up + j, mask));
+                    neighbours = mm_add<T>(neighbours, mm_mult<T>(wDown, mm_maskLoadRegister<T>(down + j, mask)));
+                    neighbours = mm_add<T>(neighbours, mm_mult<T>(wLeft, mm_loadRegisteru<T, regType>(row + j - 1)));
+                    neighbours = mm_add<T>(neighbours, mm_mult<T>(wRight, mm_loadRegisteru<T, regType>(row + j + 1)));
+                } else {
+                    // The neighbours that are not read are never loaded
+                    const regType vertical =
+                            (P::up == 1) ? mm_add<T>(mm_maskLoadRegister<T>(up + j, mask),
+                                                     mm_maskLoadRegister<T>(down + j, mask)) :
+                            (P::up == 2) ? mm_add<T>(mm_maskLoadRegister<T>(up + j, mask),
+                                                     mm_maskLoadRegister<T>(up + j, mask)) :
+                            mm_add<T>(mm_maskLoadRegister<T>(down + j, mask),
+                                      mm_maskLoadRegister<T>(down + j, mask));
+                    const regType horizontal =
+                            (P::left == 1) ? mm_add<T>(mm_loadRegisteru<T, regType>(row + j - 1),
+                                                       mm_loadRegisteru<T, regType>(row + j + 1)) :
+                            (P::left == 2) ? mm_add<T>(mm_loadRegisteru<T, regType>(row + j - 1),
+                                                       mm_loadRegisteru<T, regType>(row + j - 1)) :
+                            mm_add<T>(mm_loadRegisteru<T, regType>(row + j + 1),
+                                      mm_loadRegisteru<T, regType>(row + j + 1));
+                    neighbours = mm_mult<T>(quarter, mm_add<T>(vertical, horizontal));
+                }
+
+                if (b > 0) {
+                    mm_maskStoreRegister<T>(row + j - step, pendingMask, pending);
+                }
+
+                const regType update = mm_blend<T>(zero, mm_mult<T>(relax, mm_sub<T>(neighbours, center)), mask);
+
+                pending = mm_add<T>(center, update);
+                pendingMask = mask;
+
+                maxChange = mm_max<T>(maxChange, mm_max<T>(update, mm_sub<T>(zero, update)));
+                squares = mm_add<T>(squares, mm_mult<T>(update, update));
+            }
+
+            mm_maskStoreRegister<T>(row + (blocks - 1) * step, pendingMask, pending);
+
+            UpdateNorms<T> norms;
+
+            alignas(sizeof(regType)) T reduced[2][step];
+            *reinterpret_cast<regType *>(reduced[0]) = maxChange;
+            *reinterpret_cast<regType *>(reduced[1]) = squares;
+
+            for (size_t l = 0; l < step; ++l) {
+                norms.max = std::max(norms.max, reduced[0][l]);
+                norms.squares += reduced[1][l];
+            }
+
+            return norms;
+        }
+
+
+        // Red-black update for floating point types
+        template<unsigned Pattern,
+                typename T,
+                class Alloc,
+                typename std::enable_if<std::is_same<T, double>::value ||
+                                        std::is_same<T, float>::value, int>::type = 0>
+        inline UpdateNorms<T> redBlackRow(Matrix <T, Alloc> &plate,
+                                          const size_t i,
+                                          const size_t color,
+                                          const StencilWeights<T> &weights,
+                                          const T omega) {
+
+            assert((i > 0) && (i + 1 < plate.rows()));
+
+            if (extract_alignment<Alloc>::row_aligned) {
+#ifdef __AVX__
+                return redBlackRowSIMD<Pattern, T, Alloc, typename avx_traits<T>::reg_type>(
+                        plate, i, color, weights, omega);
+#else
+                return ::anpi::fallback::redBlackRow<Pattern>(plate, i, color, weights, omega);
+#endif
+            } else { // rows do not start on a register boundary
+                return ::anpi::fallback::redBlackRow<Pattern>(plate, i, color, weights, omega);
+            }
+        }
+
+        // Other types
+        template<unsigned Pattern,
+                typename T,
+                class Alloc,
+                typename std::enable_if<!(std::is_same<T, double>::value ||
+                                          std::is_same<T, float>::value), int>::type = 0>
+        inline UpdateNorms<T> redBlackRow(Matrix <T, Alloc> &plate,
+                                          const size_t i,
+                                          const size_t color,
+                                          const StencilWeights<T> &weights,
+                                          const T omega) {
+
+            return ::anpi::fallback::redBlackRow<Pattern>(plate, i, color, weights, omega);
+        }
+
+    } // namespace simd
+
+} // namespace anpi
+
+#endif
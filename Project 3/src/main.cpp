@@ -78,6 +78,23 @@ int main(int argc, const char *argv[]) {
                  "Número de píxeles horizontales en la solución\n")
                 ("pixel-vert,v", po::value<int >(&liebmannParams.height)->default_value(1000),
                  "Número de píxeles verticales en la solución\n")
+                ("metodo,m", po::value<std::string>(&liebmannParams.method)->default_value("jacobi"),
+                 "Método de solución: jacobi, sor, mixta, multigrid, cg o adaptativa\n")
+                ("ciclo,c", po::value<std::string>(&liebmannParams.cycle)->default_value("V"),
+                 "Ciclo de multigrid: V o W\n")
+                ("precondicionador,r", po::value<std::string>(&liebmannParams.preconditioner)->default_value("cholesky"),
+                 "Precondicionador del gradiente conjugado: jacobi o cholesky\n")
+                ("refinamiento,e", po::value<double>(&liebmannParams.refinement)->default_value(1),
+                 "Diferencia de temperatura entre celdas vecinas a partir de la cual\n"
+                 "el método adaptativo divide una celda\n")
+                ("hilos,n", po::value<size_t>(&liebmannParams.parallel.threads)->default_value(0),
+                 "Número de hilos de OpenMP, 0 usa todos los disponibles\n")
+                ("planificacion,s", po::value<std::string>(&liebmannParams.schedule)->default_value("static"),
+                 "Planificación de los ciclos paralelos: static, dynamic o guided\n")
+                ("bloque,k", po::value<size_t>(&liebmannParams.parallel.chunkSize)->default_value(0),
+                 "Iteraciones asignadas a un hilo a la vez, 0 usa el valor de la planificación\n")
+                ("umbral,u", po::value<size_t>(&liebmannParams.parallel.serialThreshold)->default_value(16384),
+                 "Placas con menos píxeles que este valor se calculan en serie\n")
                 ("quiet,q", po::value<bool>(&quiet)->default_value(false),
                  "Desactiva visualizacion\n")
                 ("flow,f", po::value<bool>(&showFlow)->default_value(true),
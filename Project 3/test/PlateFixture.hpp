@@ -0,0 +1,112 @@
+/**
+ * Copyright (C) 2018
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+#ifndef ANPI_TEST_PLATE_FIXTURE_HPP
+#define ANPI_TEST_PLATE_FIXTURE_HPP
+
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "Matrix.hpp"
+#include "Liebmann.hpp"
+
+
+namespace anpi {
+    namespace test {
+
+        /**
+         * Frontier conditions shared by the solver tests, each border at
+         * another temperature so every direction of the plate matters.
+         * Convention used: {top; bot; left; right}
+         *
+         * @tparam T        : Data type
+         * @param length    : Pixels of each border
+         * @return          : Borders at 100, 50, 250 and 33
+         */
+        template<typename T = double>
+        anpi::Matrix<T> plateBorders(const size_t length = 90) {
+            anpi::Matrix<T> borders = anpi::Matrix<T>(4, length);
+            borders.fillRow(100, 0);
+            borders.fillRow(50, 1);
+            borders.fillRow(250, 2);
+            borders.fillRow(33, 3);
+
+            return borders;
+        }
+
+        /// Options of the reference plates: red-black SOR converged to 1e-12
+        inline anpi::LiebmannOptions sorOptions() {
+            anpi::LiebmannOptions options;
+            options.method = anpi::LiebmannMethod::RedBlackSOR;
+            options.tolerance = 1e-12;
+
+            return options;
+        }
+
+        /// No isolated border, the top one, and both borders of a direction
+        inline std::vector<std::vector<bool> > isolations() {
+            return {{false, false, false, false},
+                    {true,  false, false, false},
+                    {false, false, true,  true}};
+        }
+
+        /// Wide, tall and square plates
+        inline std::vector<std::pair<size_t, size_t> > sizes() {
+            return {{60, 90}, {90, 60}, {63, 63}};
+        }
+
+        /// Largest difference between the inner pixels of two plates
+        template<class P, class Q>
+        double innerDifference(const P &plate, const Q &expected) {
+            double diff = 0;
+            for (size_t i = 1; i < plate.rows() - 1; ++i) {
+                for (size_t j = 1; j < plate.cols() - 1; ++j) {
+                    diff = std::max(diff, std::abs(double(plate(i, j)) - double(expected(i, j))));
+                }
+            }
+            return diff;
+        }
+
+        /**
+         * Solves the plate of plateBorders() for every isolation and size
+         * with red-black SOR, and hands the problem and its reference plate
+         * to the checks of a solver
+         *
+         * @param isolations    : Isolations of the plates
+         * @param sizes         : Inner rows and columns of the plates
+         * @param check         : Called as check(borders, rows, cols, isolation, expected)
+         */
+        template<class Check>
+        void compareWithSOR(const std::vector<std::vector<bool> > &isolations,
+                            const std::vector<std::pair<size_t, size_t> > &sizes,
+                            Check check) {
+
+            anpi::Matrix<double> borders = plateBorders();
+            const anpi::LiebmannOptions options = sorOptions();
+
+            for (const auto &isolation : isolations) {
+                for (const auto &size : sizes) {
+                    const anpi::Matrix<double> expected = liebmann(borders, size.first, size.second,
+                                                                   isolation, 1., true, options);
+                    check(borders, size.first, size.second, isolation, expected);
+                }
+            }
+        }
+
+        /// Same as the above, for the isolations() and sizes()
+        template<class Check>
+        void compareWithSOR(Check check) {
+            compareWithSOR(isolations(), sizes(), check);
+        }
+
+    } // namespace test
+} // namespace anpi
+
+#endif //ANPI_TEST_PLATE_FIXTURE_HPP
@@ -0,0 +1,94 @@
+/**
+ * Copyright (C) 2017
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cmath>
+
+
+/**
+ * Unit tests for the adaptive refinement solver
+ */
+
+#include "Matrix.hpp"
+#include "AdaptiveLiebmann.hpp"
+#include "ConjugateGradient.hpp"
+#include "Allocator.hpp"
+#include "PlateFixture.hpp"
+
+
+BOOST_AUTO_TEST_SUITE(AdaptiveLiebmannImplementation)
+
+
+    BOOST_AUTO_TEST_CASE(MatchesSOR) {
+        // Without a threshold every cell ends as a pixel. The last isolation
+        // is not symmetric and falls back to SOR
+        anpi::AdaptiveOptions options;
+        options.threshold = 0;
+        options.tolerance = 1e-12;
+
+        std::vector<std::vector<bool> > isolations = {{false, false, false, false},
+                                                      {true,  true,  false, false},
+                                                      {false, false, true,  false}};
+
+        anpi::test::compareWithSOR(isolations, anpi::test::sizes(), [&](anpi::Matrix<double> &borders,
+                                                                         const size_t rows,
+                                                                         const size_t cols,
+                                                                         const std::vector<bool> &bordersIsolation,
+                                                                         const anpi::Matrix<double> &expected) {
+            anpi::Matrix<double> plate = anpi::adaptiveLiebmann(borders, rows, cols, bordersIsolation, options);
+            BOOST_CHECK(anpi::test::innerDifference(plate, expected) < 1e-6);
+        });
+    }
+
+
+    BOOST_AUTO_TEST_CASE(Refinement) {
+        const size_t n = 300;
+        const std::vector<bool> bordersIsolation = {false, false, false, false};
+
+        // A narrow hot spot on the top border, the rest of the plate is flat
+        anpi::Matrix<double> borders = anpi::Matrix<double>(4, n);
+        for (size_t j = 0; j < n; ++j) {
+            const double x = double(j) / n;
+            borders(0, j) = 50 + 200 * std::exp(-400 * (x - 0.3) * (x - 0.3));
+        }
+        borders.fillRow(50, 1);
+        borders.fillRow(50, 2);
+        borders.fillRow(50, 3);
+
+        anpi::CGOptions cgOptions;
+        cgOptions.tolerance = 1e-12;
+        anpi::Matrix<double> expected = anpi::conjugateGradient(borders, n, n, bordersIsolation, cgOptions);
+
+        std::vector<size_t> cells;
+        anpi::AdaptiveOptions options;
+        options.threshold = 1;
+        options.cellHistory = &cells;
+
+        anpi::Matrix<double> plate = anpi::adaptiveLiebmann(borders, n, n, bordersIsolation, options);
+
+        // The cells only grow from pass to pass, and stay well below the pixels
+        BOOST_CHECK(!cells.empty());
+        for (size_t k = 1; k < cells.size(); ++k) {
+            BOOST_CHECK(cells[k] >= cells[k - 1]);
+        }
+        BOOST_CHECK(cells.back() < n * n / 4);
+
+        double diff = 0;
+        for (size_t i = 1; i < plate.rows() - 1; ++i) {
+            for (size_t j = 1; j < plate.cols() - 1; ++j) {
+                diff = std::max(diff, std::abs(plate(i, j) - expected(i, j)));
+            }
+        }
+        BOOST_CHECK(diff < 1);
+    }
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -9,7 +9,11 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <limits>
 #include <Allocator.hpp>
+#include <Matrix.hpp>
 
 #define COMMA ,
 
@@ -38,9 +42,144 @@ BOOST_AUTO_TEST_CASE( Allocation ) {
     
     alloc.deallocate(ptr,1024);
   }
+
+  {
+    typedef anpi::mmap_allocator<float,64> alloc_type;
+    alloc_type alloc;
+    float* ptr = alloc.allocate(1024);
+    size_t ptrcst = reinterpret_cast<size_t>(ptr);
+
+    BOOST_CHECK( ptrcst % 64 == 0);
+    ptr[1023] = 1.f; // the pages can be written
+
+    alloc.deallocate(ptr,1024);
+  }
+
+  {
+    // Falls back to transparent huge pages without a reserved pool
+    typedef anpi::mmap_allocator<double,32> alloc_type;
+    alloc_type alloc(anpi::HugePages);
+    double* ptr = alloc.allocate(1 << 20);
+    size_t ptrcst = reinterpret_cast<size_t>(ptr);
+
+    BOOST_CHECK( ptrcst % 32 == 0);
+    ptr[(1 << 20) - 1] = 1.;
+
+    alloc.deallocate(ptr,1 << 20);
+    BOOST_CHECK( alloc != alloc_type() );
+  }
   
 }
 
+BOOST_AUTO_TEST_CASE( FileMapping ) {
+  namespace fs = boost::filesystem;
+  const fs::path path = fs::temp_directory_path() / fs::unique_path();
+
+  typedef anpi::mmap_allocator<float> alloc_type;
+  typedef anpi::Matrix<float,alloc_type> matrix_type;
+
+  {
+    matrix_type a(13,17,anpi::DoNotInitialize,alloc_type(path.string()));
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        a(i,j) = float(i*a.cols()+j);
+      }
+    }
+
+    // The SIMD paths accept the mapped rows
+    matrix_type b(a);
+    b += a;
+    BOOST_CHECK( b(12,16) == 2.f*a(12,16) );
+  }
+
+  BOOST_CHECK( fs::file_size(path) >= 13*17*sizeof(float) );
+
+  {
+    // Mapping the file again reads the matrix back without copies
+    matrix_type a(13,17,anpi::DoNotInitialize,alloc_type(path.string()));
+    bool equal = true;
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        equal = equal && a(i,j) == float(i*a.cols()+j);
+      }
+    }
+    BOOST_CHECK( equal );
+  }
+
+  fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE( FileBackedProducts ) {
+  namespace fs = boost::filesystem;
+  const fs::path path = fs::temp_directory_path() / fs::unique_path();
+
+  typedef anpi::mmap_allocator<double> alloc_type;
+  typedef anpi::Matrix<double,alloc_type> matrix_type;
+
+  {
+    matrix_type a(9,9,anpi::DoNotInitialize,alloc_type(path.string()));
+    matrix_type twice(9,9,0.);
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        a(i,j) = double(i*a.cols()+j);
+      }
+      twice(i,i) = 2.;
+    }
+
+    // The product must not map the file of its operand
+    const matrix_type c = a * twice;
+    BOOST_CHECK( !c.get_allocator().backing() );
+    bool equal = true;
+    for (size_t i=0;i<a.rows();++i) {
+      for (size_t j=0;j<a.cols();++j) {
+        equal = equal && a(i,j) == double(i*a.cols()+j) && c(i,j) == 2.*a(i,j);
+      }
+    }
+    BOOST_CHECK( equal );
+    BOOST_CHECK( a(2,2) == 20. && c(2,2) == 40. );
+
+    // The in-place product keeps the file
+    a *= twice;
+    BOOST_CHECK( a == c );
+    BOOST_CHECK( a.get_allocator().backing() );
+  }
+
+  fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE( HugePagesMatrix ) {
+  typedef anpi::mmap_allocator<double> alloc_type;
+  typedef anpi::Matrix<double,alloc_type> matrix_type;
+
+  // The transposition goes through a temporary matrix, the matrix must
+  // keep the allocator that can release its huge mapping
+  matrix_type a(3,5,1.,alloc_type(anpi::HugePages));
+  a(2,4) = 2.;
+  a.transpose();
+  BOOST_CHECK( a.rows() == 5 && a.cols() == 3 );
+  BOOST_CHECK( a(4,2) == 2. );
+  BOOST_CHECK( a.get_allocator().hugePages() );
+
+  // Copies, transposed copies and results of expressions keep huge pages
+  const matrix_type copy(a);
+  BOOST_CHECK( copy(4,2) == 2. && copy.get_allocator().hugePages() );
+  const matrix_type t = a.copyTransposed();
+  BOOST_CHECK( t(2,4) == 2. && t.get_allocator().hugePages() );
+  const matrix_type sum = a + copy;
+  BOOST_CHECK( sum(4,2) == 4. && sum.get_allocator().hugePages() );
+
+  // Moving a huge mapping into a matrix of anonymous pages
+  matrix_type b(4,4,0.);
+  b = std::move(a);
+  BOOST_CHECK( b(4,2) == 2. );
+  BOOST_CHECK( b.get_allocator().hugePages() );
+  BOOST_CHECK( !a.get_allocator().hugePages() );
+
+  matrix_type c(2,2,3.,alloc_type(anpi::HugePages));
+  c.swap(b);
+  BOOST_CHECK( c(4,2) == 2. && b(1,1) == 3. );
+}
+
 BOOST_AUTO_TEST_CASE( Checks ) {
   BOOST_CHECK(!anpi::is_aligned_alloc<std::allocator<float> >::value );
   bool val = anpi::is_aligned_alloc<anpi::aligned_allocator<float,16> >::value;
@@ -69,6 +208,15 @@ BOOST_AUTO_TEST_CASE( Checks ) {
     BOOST_CHECK(ext::row_aligned == true );
   }
 
+  {
+    val = anpi::is_aligned_alloc<anpi::mmap_allocator<double,64> >::value;
+    BOOST_CHECK(val);
+
+    typedef anpi::extract_alignment<anpi::mmap_allocator<double,64> > ext;
+    BOOST_CHECK(ext::value==64);
+    BOOST_CHECK(ext::aligned == true );
+    BOOST_CHECK(ext::row_aligned == true );
+  }
   
 }
 
@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) 2017
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <complex>
+#include <chrono>
+
+
+/**
+ * Unit tests for the conjugate gradient solver
+ */
+
+#include "Matrix.hpp"
+#include "ConjugateGradient.hpp"
+#include "Allocator.hpp"
+#include "PlateFixture.hpp"
+
+
+BOOST_AUTO_TEST_SUITE(ConjugateGradientImplementation)
+
+
+    BOOST_AUTO_TEST_CASE(MatchesSOR) {
+        // The last isolation is not symmetric and falls back to SOR
+        std::vector<std::vector<bool> > isolations = {{false, false, false, false},
+                                                      {true,  true,  false, false},
+                                                      {false, false, true,  false}};
+        std::vector<anpi::CGPreconditioner> preconditioners = {anpi::CGPreconditioner::Jacobi,
+                                                               anpi::CGPreconditioner::IncompleteCholesky};
+
+        anpi::test::compareWithSOR(isolations, anpi::test::sizes(), [&](anpi::Matrix<double> &borders,
+                                                                         const size_t rows,
+                                                                         const size_t cols,
+                                                                         const std::vector<bool> &bordersIsolation,
+                                                                         const anpi::Matrix<double> &expected) {
+            for (const auto preconditioner : preconditioners) {
+                anpi::CGOptions options;
+                options.preconditioner = preconditioner;
+                options.tolerance = 1e-12;
+
+                anpi::Matrix<double> plate = anpi::conjugateGradient(borders, rows, cols, bordersIsolation, options);
+
+                for (size_t i = 1; i < plate.rows() - 1; ++i) {
+                    for (size_t j = 1; j < plate.cols() - 1; ++j) {
+                        BOOST_CHECK_CLOSE(plate(i, j), expected(i, j), 1e-6);
+                    }
+                }
+            }
+        });
+    }
+
+
+    BOOST_AUTO_TEST_CASE(Iterations) {
+        const std::vector<bool> bordersIsolation = {false, false, false, false};
+        std::vector<size_t> jacobi, cholesky;
+
+        // Doubling the side of the plate roughly doubles the iterations
+        for (const size_t n : {size_t(32), size_t(64), size_t(128)}) {
+            anpi::Matrix<double> borders = anpi::Matrix<double>(4, n);
+            borders.fillRow(100, 0);
+            borders.fillRow(0, 1);
+            borders.fillRow(50, 2);
+            borders.fillRow(75, 3);
+
+            anpi::CGOptions options;
+            options.tolerance = 1e-8;
+
+            options.preconditioner = anpi::CGPreconditioner::Jacobi;
+            anpi::Matrix<double> plate = anpi::initializePlate(borders, n, n, bordersIsolation);
+            jacobi.push_back(anpi::conjugateGradientAux(plate, bordersIsolation, options));
+
+            std::vector<double> history;
+            options.preconditioner = anpi::CGPreconditioner::IncompleteCholesky;
+            options.residualHistory = &history;
+            plate = anpi::initializePlate(borders, n, n, bordersIsolation);
+            cholesky.push_back(anpi::conjugateGradientAux(plate, bordersIsolation, options));
+
+            BOOST_CHECK(history.size() == cholesky.back());
+            BOOST_CHECK(history.back() <= 1e-8);
+            BOOST_CHECK(cholesky.back() < jacobi.back());
+        }
+
+        for (size_t k = 1; k < jacobi.size(); ++k) {
+            BOOST_CHECK(jacobi[k] < 3 * jacobi[k - 1]);
+            BOOST_CHECK(cholesky[k] < 3 * cholesky[k - 1]);
+        }
+    }
+
+
+BOOST_AUTO_TEST_SUITE_END()
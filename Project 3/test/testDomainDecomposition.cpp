@@ -0,0 +1,109 @@
+/**
+ * Copyright (C) 2017
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <complex>
+#include <chrono>
+
+
+/**
+ * Unit tests for the domain decomposed solver
+ */
+
+#include "Matrix.hpp"
+#include "DomainDecomposition.hpp"
+#include "Allocator.hpp"
+#include "PlateFixture.hpp"
+
+
+BOOST_AUTO_TEST_SUITE(DomainDecomposition)
+
+
+    BOOST_AUTO_TEST_CASE(LocalTransport) {
+        // Every rank gets the reductions of all the ranks
+        std::vector<double> maxima(3), sums(3), received(3);
+
+        anpi::runLocalRanks<double>(3, [&](anpi::Communicator<double> &comm) {
+            const double value = double(comm.rank() + 1);
+            maxima[comm.rank()] = comm.allReduceMax(value);
+            sums[comm.rank()] = comm.allReduceSum(value);
+
+            // Each rank sends its value to the next one in a ring
+            double message = 0;
+            comm.exchange((comm.rank() + 1) % comm.size(), &value,
+                          (comm.rank() + comm.size() - 1) % comm.size(), &message, 1);
+            received[comm.rank()] = message;
+        });
+
+        for (size_t r = 0; r < 3; ++r) {
+            BOOST_CHECK(maxima[r] == 3.);
+            BOOST_CHECK(sums[r] == 6.);
+            BOOST_CHECK(received[r] == double((r + 2) % 3 + 1));
+        }
+    }
+
+
+    BOOST_AUTO_TEST_CASE(DecomposedLiebmann) {
+        anpi::Matrix<double> borders = anpi::test::plateBorders(60);
+
+        std::vector<std::vector<bool> > isolations = {{false, false, false, false},
+                                                      {true,  false, false, false},
+                                                      {false, true,  true,  false}};
+
+        const anpi::LiebmannOptions sorOptions = anpi::test::sorOptions();
+
+        anpi::LiebmannOptions options;
+        options.tolerance = 1e-9;
+        options.checkEvery = 8;
+
+        for (const auto &bordersIsolation : isolations) {
+            const anpi::Matrix<double> expected = liebmann(borders, 31, 40, bordersIsolation,
+                                                           1., true, sorOptions);
+
+            // The plate does not depend on the number of ranks
+            anpi::Matrix<double> single;
+            for (const size_t ranks : {size_t(1), size_t(2), size_t(3), size_t(5)}) {
+                anpi::Matrix<double> plate;
+
+                anpi::runLocalRanks<double>(ranks, [&](anpi::Communicator<double> &comm) {
+                    anpi::Matrix<double> strip = anpi::decomposedLiebmann(comm, borders, 31, 40,
+                                                                          bordersIsolation, 1., options);
+                    anpi::Matrix<double> gathered = anpi::gatherPlate(comm, strip, 31);
+                    if (comm.rank() == 0) {
+                        plate = gathered;
+                    }
+                });
+
+                BOOST_CHECK(plate.rows() == expected.rows());
+                BOOST_CHECK(plate.cols() == expected.cols());
+
+                if (ranks == 1) {
+                    single = plate;
+                } else {
+                    BOOST_CHECK(plate == single);
+                }
+
+                for (size_t i = 1; i < plate.rows() - 1; ++i) {
+                    for (size_t j = 1; j < plate.cols() - 1; ++j) {
+                        BOOST_CHECK_CLOSE(plate(i, j), expected(i, j), 1e-3);
+                    }
+                }
+            }
+        }
+
+        // More ranks than rows can not be decomposed
+        BOOST_CHECK_THROW(anpi::runLocalRanks<double>(4, [&](anpi::Communicator<double> &comm) {
+            anpi::decomposedLiebmann(comm, borders, 3, 40, isolations[0], 1., options);
+        }), anpi::Exception);
+    }
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,18 +20,18 @@
 
 #include "Matrix.hpp"
 #include "Liebmann.hpp"
+#include "LiebmannBatch.hpp"
+#include "ConjugateGradient.hpp"
+#include "MixedPrecision.hpp"
 #include "Allocator.hpp"
+#include "PlateFixture.hpp"
 
 
 BOOST_AUTO_TEST_SUITE(LiebmannImplementation)
 
 
     BOOST_AUTO_TEST_CASE(Liebmann) {
-        anpi::Matrix<double> borders = anpi::Matrix<double>(4, 1000);
-        borders.fillRow(100, 0);
-        borders.fillRow(50, 1);
-        borders.fillRow(250, 2);
-        borders.fillRow(33, 3);
+        anpi::Matrix<double> borders = anpi::test::plateBorders(1000);
 
 
         std::vector<bool> bordersIsolation = {false, false, false, false};
@@ -50,5 +50,560 @@ BOOST_AUTO_TEST_SUITE(LiebmannImplementation)
         //25K x 25K = 48123.4 ms; OpenMP
     }
 
+    BOOST_AUTO_TEST_CASE(IsolatedEdges) {
+        anpi::LiebmannOptions options;
+        options.method = anpi::LiebmannMethod::RedBlackSOR;
+        options.tolerance = 1e-10;
+
+        // Wide and tall plates, the tall one is solved transposed
+        const std::vector<std::pair<size_t, size_t> > sizes = {{60, 90}, {90, 60}};
+
+        for (size_t edge = 0; edge < 4; ++edge) {
+            std::vector<bool> bordersIsolation = {false, false, false, false};
+            bordersIsolation[edge] = true;
+
+            // The pixels reuse the neighbour opposite to the isolated edge
+            const anpi::StencilWeights<double> w = anpi::isolationWeights<double>(bordersIsolation);
+            const double weights[] = {w.up, w.down, w.left, w.right};
+            for (size_t k = 0; k < 4; ++k) {
+                const double expected = (k == edge) ? 0. : ((k == (edge ^ 1u)) ? 0.5 : 0.25);
+                BOOST_CHECK_EQUAL(weights[k], expected);
+            }
+
+            // An isolated edge lets no heat through, so its frontier condition
+            // must not reach the plate
+            for (const auto &size : sizes) {
+                anpi::Matrix<double> borders = anpi::Matrix<double>(4, 90, 100.);
+                borders.fillRow(0, edge);
+
+                anpi::Matrix<double> b = liebmann(borders, size.first, size.second, bordersIsolation,
+                                                  1., true, options);
+
+                double error = 0;
+                for (size_t i = 1; i < b.rows() - 1; ++i) {
+                    for (size_t j = 1; j < b.cols() - 1; ++j) {
+                        error = std::max(error, std::abs(b(i, j) - 100.));
+                    }
+                }
+                BOOST_CHECK(error < 1e-6);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(RedBlackSOR) {
+        anpi::Matrix<double> borders = anpi::test::plateBorders();
+
+        anpi::LiebmannOptions options;
+        options.method = anpi::LiebmannMethod::RedBlackSOR;
+        options.tolerance = 1e-10;
+
+        for (const auto &bordersIsolation : anpi::test::isolations()) {
+            anpi::Matrix<double> b = liebmann(borders, 60, 90, bordersIsolation, 1., true, options);
+            const anpi::StencilWeights<double> w = anpi::isolationWeights<double>(bordersIsolation);
+
+            // Every inner pixel must satisfy the stencil
+            double residual = 0;
+            for (size_t i = 1; i < b.rows() - 1; ++i) {
+                for (size_t j = 1; j < b.cols() - 1; ++j) {
+                    residual = std::max(residual, std::abs(w.up * b(i - 1, j) + w.down * b(i + 1, j) +
+                                                           w.left * b(i, j - 1) + w.right * b(i, j + 1) - b(i, j)));
+                }
+            }
+            BOOST_CHECK(residual < 1e-8);
+        }
+    }
+
+    template<typename T>
+    void testStencilKernel() {
+        const std::vector<size_t> sizes = {3, 4, 9, 16, 17, 31, 33};
+        const std::vector<bool> bordersIsolation = {true, false, false, true};
+        const anpi::StencilWeights<T> weights = anpi::isolationWeights<T>(bordersIsolation);
+        const T lambda = T(1.25);
+
+        for (const size_t cols : sizes) {
+            anpi::Matrix<T> in(5, cols), simd(5, cols, T(-1)), fallback(5, cols, T(-1));
+
+            for (size_t i = 0; i < in.rows(); ++i) {
+                for (size_t j = 0; j < in.cols(); ++j) {
+                    in(i, j) = T((i * 37 + j * 11) % 17);
+                }
+            }
+            simd = in;
+            fallback = in;
+
+            for (size_t i = 1; i < in.rows() - 1; ++i) {
+                anpi::simd::stencilRow(simd, in, i, weights, lambda);
+                anpi::fallback::stencilRow(fallback, in, i, weights, lambda);
+            }
+
+            // Same values on the inner pixels, untouched borders
+            for (size_t i = 0; i < in.rows(); ++i) {
+                for (size_t j = 0; j < in.cols(); ++j) {
+                    BOOST_CHECK_CLOSE(simd(i, j), fallback(i, j), 1e-4);
+                    if (i == 0 || j == 0 || i + 1 == in.rows() || j + 1 == in.cols()) {
+                        BOOST_CHECK(simd(i, j) == in(i, j));
+                    }
+                }
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(StencilKernel) {
+        testStencilKernel<float>();
+        testStencilKernel<double>();
+    }
+
+    template<typename T>
+    void testIsolationPatterns() {
+        const T lambda = T(1.25);
+
+        anpi::Matrix<T> in(6, 29);
+        for (size_t i = 0; i < in.rows(); ++i) {
+            for (size_t j = 0; j < in.cols(); ++j) {
+                in(i, j) = T((i * 37 + j * 11) % 17);
+            }
+        }
+
+        // Weights that do not belong to a pattern use the generic kernel
+        BOOST_CHECK(anpi::isolationPattern(anpi::StencilWeights<T>{T(0.3), T(0.2), T(0.25), T(0.25)}) ==
+                    anpi::AnyIsolation);
+
+        for (unsigned mask = 0; mask < 16; ++mask) {
+            const std::vector<bool> isolation = {(mask & 1u) != 0, (mask & 2u) != 0,
+                                                 (mask & 4u) != 0, (mask & 8u) != 0};
+            const anpi::StencilWeights<T> weights = anpi::isolationWeights<T>(isolation);
+
+            // Directions with both borders isolated have the stencil of no isolation
+            unsigned expected = mask;
+            if ((expected & 3u) == 3u) expected &= ~3u;
+            if ((expected & 12u) == 12u) expected &= ~12u;
+            BOOST_CHECK(anpi::isolationPattern(weights) == expected);
+
+            anpi::Matrix<T> generic = in, simd = in, fallback = in;
+            anpi::dispatchIsolation(mask, [&](auto pattern) {
+                constexpr unsigned Pattern = decltype(pattern)::value;
+                BOOST_CHECK(Pattern == expected);
+
+                for (size_t i = 1; i < in.rows() - 1; ++i) {
+                    anpi::fallback::stencilRow(generic, in, i, weights, lambda);
+                    anpi::simd::stencilRow<Pattern>(simd, in, i, weights, lambda);
+                    anpi::fallback::stencilRow<Pattern>(fallback, in, i, weights, lambda);
+                }
+            });
+
+            for (size_t i = 0; i < in.rows(); ++i) {
+                for (size_t j = 0; j < in.cols(); ++j) {
+                    BOOST_CHECK_CLOSE(simd(i, j), generic(i, j), 1e-4);
+                    BOOST_CHECK_CLOSE(fallback(i, j), generic(i, j), 1e-4);
+                }
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(IsolationPatterns) {
+        testIsolationPatterns<float>();
+        testIsolationPatterns<double>();
+    }
+
+    BOOST_AUTO_TEST_CASE(TemporalBlocking) {
+        const std::vector<bool> bordersIsolation = {false, true, true, false};
+        const anpi::StencilWeights<double> weights = anpi::isolationWeights<double>(bordersIsolation);
+        const double lambda = 1.1;
+        const size_t iterations = 5;
+
+        anpi::Matrix<double> start(41, 37);
+        for (size_t i = 0; i < start.rows(); ++i) {
+            for (size_t j = 0; j < start.cols(); ++j) {
+                start(i, j) = double((i * 37 + j * 11) % 17);
+            }
+        }
+
+        // Reference: one sweep of the whole plate per iteration
+        anpi::Matrix<double> expected = start, last;
+        for (size_t k = 0; k < iterations; ++k) {
+            last = expected;
+            for (size_t i = 1; i < expected.rows() - 1; ++i) {
+                anpi::aimpl::stencilRow(expected, last, i, weights, lambda);
+            }
+        }
+
+        for (const size_t tileSize : {size_t(0), size_t(1), size_t(3), size_t(8), size_t(100)}) {
+            anpi::Matrix<double> b = start;
+            anpi::temporalBlockedJacobi(b, start, weights, lambda, iterations, tileSize);
+
+            for (size_t i = 0; i < b.rows(); ++i) {
+                for (size_t j = 0; j < b.cols(); ++j) {
+                    BOOST_CHECK_CLOSE(b(i, j), expected(i, j), 1e-10);
+                }
+            }
+        }
+
+        // The solver reaches the same plate with blocked sweeps
+        anpi::Matrix<double> borders = anpi::test::plateBorders();
+
+        anpi::LiebmannOptions options;
+        options.tileIterations = 8;
+        anpi::Matrix<double> blocked = liebmann(borders, 30, 90, bordersIsolation, 1., true, options);
+        anpi::Matrix<double> plain = liebmann(borders, 30, 90, bordersIsolation);
+
+        for (size_t i = 0; i < plain.rows(); ++i) {
+            for (size_t j = 0; j < plain.cols(); ++j) {
+                BOOST_CHECK(std::abs(blocked(i, j) - plain(i, j)) < 1);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(ConvergenceMonitor) {
+        const std::vector<bool> bordersIsolation = {false, false, true, false};
+        const anpi::StencilWeights<double> weights = anpi::isolationWeights<double>(bordersIsolation);
+
+        // The norms of the vectorized kernel match the ones of the fallback
+        anpi::Matrix<double> in(7, 45), simd, fallback;
+        for (size_t i = 0; i < in.rows(); ++i) {
+            for (size_t j = 0; j < in.cols(); ++j) {
+                in(i, j) = double((i * 37 + j * 11) % 17);
+            }
+        }
+        simd = in;
+        fallback = in;
+
+        anpi::UpdateNorms<double> simdNorms, fallbackNorms;
+        for (size_t i = 1; i < in.rows() - 1; ++i) {
+            simdNorms += anpi::simd::stencilRowNorms(simd, in, i, weights, 1.);
+            fallbackNorms += anpi::fallback::stencilRowNorms(fallback, in, i, weights, 1.);
+        }
+        BOOST_CHECK_CLOSE(simdNorms.max, fallbackNorms.max, 1e-10);
+        BOOST_CHECK_CLOSE(simdNorms.squares, fallbackNorms.squares, 1e-10);
+        BOOST_CHECK(simdNorms.count == (in.rows() - 2) * (in.cols() - 2));
+
+        // Only one of every checkEvery iterations is checked and recorded
+        anpi::ConvergenceMonitor<double> monitor(1e-3, anpi::ConvergenceNorm::L2, 3);
+        anpi::UpdateNorms<double> norms;
+        norms.squares = 4;
+        norms.count = 1;
+        for (size_t k = 0; k < 6; ++k) {
+            BOOST_CHECK(!monitor.update(norms));
+        }
+        BOOST_CHECK(monitor.history().size() == 2);
+        BOOST_CHECK_CLOSE(monitor.residual(), 2., 1e-10);
+
+        // Both solvers report a decreasing residual history
+        anpi::Matrix<double> borders = anpi::test::plateBorders();
+
+        for (const auto method : {anpi::LiebmannMethod::Jacobi, anpi::LiebmannMethod::RedBlackSOR}) {
+            std::vector<double> history;
+            anpi::LiebmannOptions options;
+            options.method = method;
+            options.norm = anpi::ConvergenceNorm::L2;
+            options.checkEvery = 4;
+            options.residualHistory = &history;
+
+            liebmann(borders, 30, 90, bordersIsolation, 1., true, options);
+
+            BOOST_CHECK(history.size() > 1);
+            BOOST_CHECK(history.back() < history.front());
+        }
+    }
+
+
+    BOOST_AUTO_TEST_CASE(ParallelOptions) {
+        anpi::ParallelOptions parallel;
+
+        // Small regions and disabled OpenMP run serially
+        BOOST_CHECK(parallel.threadsFor(parallel.serialThreshold - 1, 100) == 1);
+        parallel.isUsingOpenMP = false;
+        BOOST_CHECK(parallel.threadsFor(parallel.serialThreshold * 4, 100) == 1);
+
+        // No more threads than the requested ones nor than the iterations
+        parallel.isUsingOpenMP = true;
+        parallel.threads = 3;
+        BOOST_CHECK(parallel.threadsFor(parallel.serialThreshold, 2) <= 2);
+        BOOST_CHECK(parallel.threadsFor(parallel.serialThreshold, 100) <= 3);
+
+        // The plate does not depend on the threads nor the schedule
+        anpi::Matrix<double> borders = anpi::test::plateBorders(300);
+        const std::vector<bool> bordersIsolation = {false, true, false, false};
+
+        // The sweep split among the threads matches the serial one
+        anpi::Matrix<double> source(40, 70), serial(40, 70), threaded(40, 70);
+        for (size_t i = 0; i < source.rows(); ++i) {
+            for (size_t j = 0; j < source.cols(); ++j) {
+                source(i, j) = double((i * 13 + j * 7) % 23);
+            }
+        }
+        const anpi::StencilWeights<double> weights = anpi::isolationWeights<double>(bordersIsolation);
+        anpi::ParallelOptions serialOptions, threadedOptions;
+        serialOptions.isUsingOpenMP = false;
+        threadedOptions.threads = 2;
+        threadedOptions.serialThreshold = 0;
+
+        const anpi::UpdateNorms<double> serialNorms =
+                anpi::jacobiSweep(serial, source, weights, 1., true, serialOptions);
+        const anpi::UpdateNorms<double> threadedNorms =
+                anpi::jacobiSweep(threaded, source, weights, 1., true, threadedOptions);
+        BOOST_CHECK(serialNorms.max == threadedNorms.max);
+        BOOST_CHECK_CLOSE(serialNorms.squares, threadedNorms.squares, 1e-10);
+        BOOST_CHECK(serialNorms.count == threadedNorms.count);
+        for (size_t i = 1; i < source.rows() - 1; ++i) {
+            for (size_t j = 1; j < source.cols() - 1; ++j) {
+                BOOST_CHECK(serial(i, j) == threaded(i, j));
+            }
+        }
+
+        anpi::LiebmannOptions options;
+        options.parallel.threads = 1;
+        const anpi::Matrix<double> reference = liebmann(borders, 150, 300, bordersIsolation, 1., true, options);
+
+        for (const auto schedule : {anpi::ParallelSchedule::Static,
+                                    anpi::ParallelSchedule::Dynamic,
+                                    anpi::ParallelSchedule::Guided}) {
+            options.parallel.threads = 2;
+            options.parallel.schedule = schedule;
+            options.parallel.chunkSize = 4;
+            options.parallel.serialThreshold = 0;
+
+            const anpi::Matrix<double> plate = liebmann(borders, 150, 300, bordersIsolation, 1., true, options);
+            BOOST_CHECK(plate == reference);
+        }
+    }
+
+
+    BOOST_AUTO_TEST_CASE(WarmStart) {
+        // Resampling keeps a bilinear plate exactly
+        anpi::Matrix<double> linear(7, 9);
+        for (size_t i = 0; i < linear.rows(); ++i) {
+            for (size_t j = 0; j < linear.cols(); ++j) {
+                linear(i, j) = 3. * double(i) / 6. + 5. * double(j) / 8.;
+            }
+        }
+        const anpi::Matrix<double> resampled = anpi::resamplePlate(linear, 13, 5);
+        for (size_t i = 0; i < resampled.rows(); ++i) {
+            for (size_t j = 0; j < resampled.cols(); ++j) {
+                BOOST_CHECK_CLOSE(resampled(i, j) + 1., 3. * double(i) / 12. + 5. * double(j) / 4. + 1., 1e-10);
+            }
+        }
+
+        anpi::Matrix<double> borders = anpi::test::plateBorders(120);
+        const std::vector<bool> bordersIsolation = {false, true, false, false};
+
+        for (const auto method : {anpi::LiebmannMethod::Jacobi, anpi::LiebmannMethod::RedBlackSOR}) {
+            anpi::LiebmannOptions options;
+            options.method = anpi::LiebmannMethod::RedBlackSOR;
+            options.tolerance = 1e-10;
+            const anpi::Matrix<double> previous = liebmann(borders, 60, 120, bordersIsolation, 1., true, options);
+            const anpi::Matrix<double> coarse = liebmann(borders, 30, 60, bordersIsolation, 1., true, options);
+
+            // A slightly hotter top border
+            anpi::Matrix<double> changed = borders;
+            changed.fillRow(101, 0);
+            std::vector<double> cold, warm, resampledWarm;
+
+            const anpi::Matrix<double> expected = liebmann(changed, 60, 120, bordersIsolation, 1., true, options);
+
+            // Starting from the average of the borders needs more iterations
+            options.method = method;
+            options.tolerance = 1e-6;
+            options.residualHistory = &cold;
+            const anpi::Matrix<double> average = anpi::initializePlate(changed, 60, 120, bordersIsolation);
+            liebmann(changed, 60, 120, bordersIsolation, average, 1., true, options);
+
+            options.residualHistory = &warm;
+            const anpi::Matrix<double> plate = liebmann(changed, 60, 120, bordersIsolation, previous,
+                                                        1., true, options);
+
+            options.residualHistory = &resampledWarm;
+            const anpi::Matrix<double> fromCoarse = liebmann(changed, 60, 120, bordersIsolation, coarse,
+                                                             1., true, options);
+
+            BOOST_CHECK(warm.size() < cold.size());
+            BOOST_CHECK(resampledWarm.size() < cold.size());
+
+            for (size_t i = 1; i < plate.rows() - 1; ++i) {
+                for (size_t j = 1; j < plate.cols() - 1; ++j) {
+                    BOOST_CHECK_CLOSE(plate(i, j), expected(i, j), 0.1);
+                    BOOST_CHECK_CLOSE(fromCoarse(i, j), expected(i, j), 0.1);
+                }
+            }
+        }
+    }
+
+
+    BOOST_AUTO_TEST_CASE(Batch) {
+        std::vector<anpi::PlateProblem<double> > problems(12);
+        std::vector<std::pair<size_t, size_t> > sizes = {{50, 50}, {40, 70}, {70, 40}};
+        std::vector<std::vector<bool> > isolations = {{false, false, false, false},
+                                                      {true,  false, false, false},
+                                                      {false, false, true,  true}};
+
+        for (size_t k = 0; k < problems.size(); ++k) {
+            anpi::PlateProblem<double> &problem = problems[k];
+            problem.verticalLength = sizes[k % 3].first;
+            problem.horizontalLength = sizes[k % 3].second;
+            problem.isIsolated = isolations[(k / 3) % 3];
+            problem.frontierConditions = anpi::Matrix<double>(4, 70);
+            problem.frontierConditions.fillRow(100 + double(k), 0);
+            problem.frontierConditions.fillRow(50, 1);
+            problem.frontierConditions.fillRow(250 - double(k), 2);
+            problem.frontierConditions.fillRow(33, 3);
+        }
+
+        for (const auto method : {anpi::LiebmannMethod::Jacobi, anpi::LiebmannMethod::RedBlackSOR}) {
+            anpi::LiebmannOptions options;
+            options.method = method;
+            options.parallel.threads = 3;
+            options.parallel.schedule = anpi::ParallelSchedule::Dynamic;
+            options.parallel.serialThreshold = 0;
+
+            // The second batch reuses the result matrices
+            std::vector<anpi::Matrix<double> > results;
+            for (size_t batch = 0; batch < 2; ++batch) {
+                anpi::liebmannBatch(problems, results, 1., options);
+                BOOST_CHECK(results.size() == problems.size());
+
+                for (size_t k = 0; k < problems.size(); ++k) {
+                    anpi::PlateProblem<double> &problem = problems[k];
+                    const anpi::Matrix<double> expected = liebmann(problem.frontierConditions,
+                                                                   problem.verticalLength,
+                                                                   problem.horizontalLength,
+                                                                   problem.isIsolated, 1., false, options);
+
+                    // Same algorithm as a single plate
+                    BOOST_CHECK(results[k] == expected);
+                }
+            }
+        }
+
+        // A fully isolated plate is rejected before any plate is solved
+        std::vector<anpi::Matrix<double> > results;
+        problems[5].isIsolated = {true, true, true, true};
+        BOOST_CHECK_THROW(anpi::liebmannBatch(problems, results), anpi::Exception);
+    }
+
+
+    BOOST_AUTO_TEST_CASE(UnreachableTolerance) {
+        anpi::Matrix<float> borders(4, 40);
+        borders.fillRow(100, 0);
+        borders.fillRow(50, 1);
+        borders.fillRow(25, 2);
+        borders.fillRow(75, 3);
+        const std::vector<bool> isolation = {false, false, false, false};
+        const anpi::Matrix<float> guess = anpi::initializePlate(borders, 30, 40, isolation);
+
+        // A float plate never changes less than 1e-10, so the sweeps stop
+        // at the iteration limit
+        for (const auto method : {anpi::LiebmannMethod::Jacobi, anpi::LiebmannMethod::RedBlackSOR}) {
+            std::vector<double> history;
+            anpi::LiebmannOptions options;
+            options.method = method;
+            options.tolerance = 1e-10;
+            options.maxIterations = 200;
+            options.residualHistory = &history;
+
+            anpi::liebmann(borders, 30, 40, isolation, guess, 1.f, false, options);
+            BOOST_CHECK(history.size() == options.maxIterations);
+        }
+    }
+
+
+    BOOST_AUTO_TEST_CASE(Workspace) {
+        anpi::Matrix<double> frontier(4, 60);
+        frontier.fillRow(100, 0);
+        frontier.fillRow(50, 1);
+        frontier.fillRow(25, 2);
+        frontier.fillRow(75, 3);
+        const std::vector<bool> isolation = {false, true, false, false};
+
+        anpi::LiebmannWorkspace<double> workspace;
+
+        for (const auto &size : {std::make_pair(size_t(40), size_t(60)), std::make_pair(size_t(40), size_t(60)),
+                                std::make_pair(size_t(30), size_t(20))}) {
+            anpi::Matrix<double> expected, plate;
+            anpi::initializePlate(frontier, size.first, size.second, isolation, expected);
+            anpi::initializePlate(frontier, size.first, size.second, isolation, plate);
+
+            anpi::liebmannAux(expected, isolation, 1., false);
+            anpi::liebmannAux(plate, isolation, 1., false, anpi::LiebmannOptions(), workspace);
+            BOOST_CHECK(plate == expected);
+
+            // The back grid stays in the workspace for the next plate
+            BOOST_CHECK(workspace.back.rows() == plate.rows() && workspace.back.cols() == plate.cols());
+        }
+    }
+
+
+    BOOST_AUTO_TEST_CASE(Orientation) {
+        anpi::Matrix<double> borders = anpi::test::plateBorders(250);
+
+        // The same plate rotated: top <-> left and bot <-> right
+        anpi::Matrix<double> rotated = anpi::Matrix<double>(4, 250);
+        rotated.fillRow(250, 0);
+        rotated.fillRow(33, 1);
+        rotated.fillRow(100, 2);
+        rotated.fillRow(50, 3);
+
+        const std::vector<bool> wideIsolation = {false, true, false, false};
+        const std::vector<bool> tallIsolation = {false, false, false, true};
+
+        // Tall plates are solved as they are, the result is the wide one rotated
+        for (const auto method : {anpi::LiebmannMethod::Jacobi, anpi::LiebmannMethod::RedBlackSOR}) {
+            anpi::LiebmannOptions options;
+            options.method = method;
+
+            const anpi::Matrix<double> wide = liebmann(borders, 61, 90, wideIsolation, 1., true, options);
+            const anpi::Matrix<double> tall = liebmann(rotated, 90, 61, tallIsolation, 1., true, options);
+
+            BOOST_CHECK(tall.rows() == wide.cols());
+            BOOST_CHECK(tall.cols() == wide.rows());
+            for (size_t i = 1; i < wide.rows() - 1; ++i) {
+                for (size_t j = 1; j < wide.cols() - 1; ++j) {
+                    BOOST_CHECK_CLOSE(tall(j, i), wide(i, j), 1e-6);
+                }
+            }
+        }
+
+        // Plates more than twice as long as wide
+        const anpi::LiebmannOptions sorOptions = anpi::test::sorOptions();
+
+        anpi::CGOptions cgOptions;
+        cgOptions.tolerance = 1e-12;
+
+        const std::vector<bool> open = {false, false, false, false};
+        std::vector<std::pair<size_t, size_t> > sizes = {{37, 250}, {250, 37}, {20, 170}};
+
+        for (const auto &size : sizes) {
+            const anpi::Matrix<double> plate = liebmann(borders, size.first, size.second, open, 1., true, sorOptions);
+            const anpi::Matrix<double> expected = anpi::conjugateGradient(borders, size.first, size.second,
+                                                                          open, cgOptions);
+
+            for (size_t i = 1; i < plate.rows() - 1; ++i) {
+                for (size_t j = 1; j < plate.cols() - 1; ++j) {
+                    BOOST_CHECK_CLOSE(plate(i, j), expected(i, j), 1e-6);
+                }
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(MixedPrecision) {
+        anpi::Matrix<double> borders = anpi::test::plateBorders();
+
+        const anpi::LiebmannOptions options = anpi::test::sorOptions();
+
+        // The plate is relaxed in float and finished in double
+        for (const auto &isolation : {std::vector<bool>{false, false, false, false},
+                                      std::vector<bool>{true, false, false, false},
+                                      std::vector<bool>{false, true, false, true}}) {
+            const anpi::Matrix<double> expected = liebmann(borders, 61, 90, isolation, 1., true, options);
+            const anpi::Matrix<double> mixed = anpi::mixedPrecisionLiebmann(borders, 61, 90, isolation, true, options);
+
+            BOOST_CHECK(mixed.rows() == expected.rows());
+            BOOST_CHECK(mixed.cols() == expected.cols());
+            for (size_t i = 0; i < expected.rows(); ++i) {
+                for (size_t j = 0; j < expected.cols(); ++j) {
+                    BOOST_CHECK_CLOSE(mixed(i, j), expected(i, j), 1e-6);
+                }
+            }
+        }
+    }
+
 
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
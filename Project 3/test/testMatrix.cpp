@@ -12,6 +12,8 @@
 #include <exception>
 #include <cstdlib>
 #include <complex>
+#include <limits>
+#include <vector>
 
 /**
  * Unit tests for the matrix class
@@ -19,6 +21,9 @@
 
 #include "Matrix.hpp"
 #include "Allocator.hpp"
+#include "PingPong.hpp"
+#include "HalfPrecision.hpp"
+#include "bits/IntrinsicsMethods.hpp"
 
 // Explicit instantiation of all methods of Matrix
 
@@ -334,4 +339,429 @@ BOOST_AUTO_TEST_SUITE(Matrix)
         dispatchTest(testArithmetic);
     }
 
+    template<class M>
+    void testExpressions() {
+        typedef typename M::value_type T;
+
+        // Sizes with and without whole registers. The entries and factors
+        // are small integers, so the results are exact in every type
+        const std::vector<std::pair<size_t, size_t> > sizes = {{1, 1}, {2, 8}, {7, 13}, {33, 70}};
+
+        for (const std::pair<size_t, size_t> &size : sizes) {
+            M a(size.first, size.second, anpi::DoNotInitialize);
+            M b(size.first, size.second, anpi::DoNotInitialize);
+            M c(size.first, size.second, anpi::DoNotInitialize);
+            for (size_t i = 0; i < a.rows(); ++i) {
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    a(i, j) = T(int((i + 2 * j) % 7) - 3);
+                    b(i, j) = T(int((3 * i + j) % 5) - 2);
+                    c(i, j) = T(int((i * j) % 3));
+                }
+            }
+
+            M chain(a.rows(), a.cols(), anpi::DoNotInitialize);
+            M blend(a.rows(), a.cols(), anpi::DoNotInitialize);
+            for (size_t i = 0; i < a.rows(); ++i) {
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    chain(i, j) = a(i, j) + b(i, j) - c(i, j);
+                    blend(i, j) = T(3) * a(i, j) + T(-2) * b(i, j);
+                }
+            }
+
+            M r = a + b - c;
+            BOOST_CHECK(r == chain);
+            BOOST_CHECK(a + b - c == chain);
+            BOOST_CHECK(chain == a + (b - c));
+
+            r = 3 * a + (1 - 3) * b;
+            BOOST_CHECK(r == blend);
+            BOOST_CHECK(a * 3 - b * 2 == blend);
+
+            // The expression may read the matrix it is assigned to
+            r = a;
+            r = r + b - c;
+            BOOST_CHECK(r == chain);
+
+            r = a;
+            r += b - c;
+            BOOST_CHECK(r == chain);
+
+            r = chain;
+            r -= b - c;
+            BOOST_CHECK(r == a);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(Expressions) {
+        dispatchTest(testExpressions);
+    }
+
+    template<class M>
+    void testScalarOperations() {
+        typedef typename M::value_type T;
+
+        // The entries are multiples of the factors, so the quotients are
+        // exact in every type
+        const std::vector<std::pair<size_t, size_t> > sizes = {{1, 1}, {2, 8}, {7, 13}, {33, 70}};
+
+        for (const std::pair<size_t, size_t> &size : sizes) {
+            M a(size.first, size.second, anpi::DoNotInitialize);
+            M twice(size.first, size.second, anpi::DoNotInitialize);
+            M half(size.first, size.second, anpi::DoNotInitialize);
+            for (size_t i = 0; i < a.rows(); ++i) {
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    a(i, j) = T(4 * (int((i + 2 * j) % 7) - 3));
+                    twice(i, j) = T(2) * a(i, j);
+                    half(i, j) = a(i, j) / T(2);
+                }
+            }
+
+            M r = a / 2;
+            BOOST_CHECK(r == half);
+            BOOST_CHECK(2 * a / 4 == half);
+
+            r = a;
+            r *= 2;
+            BOOST_CHECK(r == twice);
+            r /= 4;
+            BOOST_CHECK(r == half);
+
+            BOOST_CHECK_THROW(a / 0, anpi::Exception);
+            BOOST_CHECK_THROW(r /= 0, anpi::Exception);
+
+            // >= fails on any entry, also on the last one after the registers
+            M b = a;
+            BOOST_CHECK(a >= b);
+            b(b.rows() - 1, b.cols() - 1) += T(1);
+            BOOST_CHECK(!(a >= b));
+            BOOST_CHECK(b >= a);
+            b = a;
+            b(0, 0) += T(1);
+            BOOST_CHECK(!(a >= b));
+        }
+
+        // Matrices with only one different dimension are not comparable
+        M a(3, 4, T(1));
+        M b(2, 4, T(0));
+        BOOST_CHECK_THROW(a >= b, anpi::Exception);
+    }
+
+    BOOST_AUTO_TEST_CASE(ScalarOperations) {
+        dispatchTest(testScalarOperations);
+    }
+
+    template<class M>
+    void testElementWiseParallel() {
+        typedef typename M::value_type T;
+
+        // Small integers, so the sums are exact in any order
+        M a(37, 45, anpi::DoNotInitialize);
+        M b(37, 45, anpi::DoNotInitialize);
+        T total = T(0);
+        for (size_t i = 0; i < a.rows(); ++i) {
+            for (size_t j = 0; j < a.cols(); ++j) {
+                a(i, j) = T(int((i + 2 * j) % 7) - 3);
+                b(i, j) = T(int((3 * i + j) % 5) - 2);
+                total += a(i, j);
+            }
+        }
+
+        anpi::ParallelOptions serial;
+        serial.isUsingOpenMP = false;
+
+        anpi::ParallelOptions threaded;
+        threaded.threads = 4;
+        threaded.serialThreshold = 0;
+
+        // Per call
+        M expected, r;
+        anpi::evaluate(expected, 2 * a - b, serial);
+        anpi::evaluate(r, 2 * a - b, threaded);
+        BOOST_CHECK(r == expected);
+        BOOST_CHECK(r.rows() == a.rows() && r.cols() == a.cols());
+
+        BOOST_CHECK(anpi::sum(a, threaded) == total);
+        BOOST_CHECK(anpi::sum(a - a, threaded) == T(0));
+        BOOST_CHECK(anpi::maxAbs(a, threaded) == T(3));
+        BOOST_CHECK(anpi::maxAbs(T(-4) * a, serial) == T(12));
+
+        M f(a.rows(), a.cols(), anpi::DoNotInitialize);
+        f.fill(T(5), threaded);
+        BOOST_CHECK(f == M(a.rows(), a.cols(), T(5)));
+
+        // Globally, for the operators
+        const anpi::ParallelOptions global = anpi::elementWiseParallel();
+        anpi::elementWiseParallel() = threaded;
+
+        r = a;
+        r += b;
+        r -= b;
+        BOOST_CHECK(r == a);
+        r *= 2;
+        BOOST_CHECK(r == expected + b);
+        BOOST_CHECK(anpi::sum(r) == T(2) * total);
+
+        anpi::elementWiseParallel() = global;
+    }
+
+    BOOST_AUTO_TEST_CASE(ElementWiseParallel) {
+        dispatchTest(testElementWiseParallel);
+    }
+
+    template<class M>
+    void testTranspose() {
+        typedef typename M::value_type T;
+
+        {
+            M a = {{1, 2, 3},
+                   {4, 5, 6}};
+            M r = {{1, 4},
+                   {2, 5},
+                   {3, 6}};
+
+            BOOST_CHECK(a.copyTransposed() == r);
+
+            a.transpose();
+            BOOST_CHECK(a == r);
+        }
+
+        // Sizes with and without whole register blocks and cache tiles
+        const std::vector<std::pair<size_t, size_t> > sizes =
+                {{1, 1}, {7, 7}, {8, 8}, {13, 21}, {32, 32}, {64, 40}, {37, 70}, {71, 71}};
+
+        for (const std::pair<size_t, size_t> &size : sizes) {
+            M a(size.first, size.second, anpi::DoNotInitialize);
+            for (size_t i = 0; i < a.rows(); ++i) {
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    a(i, j) = T(i * a.cols() + j);
+                }
+            }
+
+            M r(a.cols(), a.rows(), anpi::DoNotInitialize);
+            for (size_t i = 0; i < r.rows(); ++i) {
+                for (size_t j = 0; j < r.cols(); ++j) {
+                    r(i, j) = a(j, i);
+                }
+            }
+
+            BOOST_CHECK(a.copyTransposed() == r);
+
+            a.transpose();
+            BOOST_CHECK(a == r);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(Transpose) {
+        dispatchTest(testTranspose);
+    }
+
+    template<class M>
+    void testMultiplication() {
+        typedef typename M::value_type T;
+
+        {
+            M a = {{1, 2, 3},
+                   {4, 5, 6}};
+            M b = {{7,  8},
+                   {9,  10},
+                   {11, 12}};
+            M r = {{58,  64},
+                   {139, 154}};
+
+            BOOST_CHECK(a * b == r);
+
+            a *= b;
+            BOOST_CHECK(a == r);
+
+            BOOST_CHECK_THROW(b *= b, anpi::Exception);
+        }
+
+        // Sizes with and without whole register blocks and cache blocks,
+        // as {rows of a, columns of a, columns of b}. The entries are small
+        // integers, so the products are exact in every type
+        const std::vector<std::vector<size_t> > sizes =
+                {{1, 1, 1}, {2, 3, 4}, {7, 13, 5}, {6, 16, 16}, {97, 300, 41}, {200, 270, 130}};
+
+        for (const std::vector<size_t> &size : sizes) {
+            M a(size[0], size[1], anpi::DoNotInitialize);
+            M b(size[1], size[2], anpi::DoNotInitialize);
+            for (size_t i = 0; i < a.rows(); ++i) {
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    a(i, j) = T(int((i + 2 * j) % 7) - 3);
+                }
+            }
+            for (size_t i = 0; i < b.rows(); ++i) {
+                for (size_t j = 0; j < b.cols(); ++j) {
+                    b(i, j) = T(int((3 * i + j) % 5) - 2);
+                }
+            }
+
+            M r(a.rows(), b.cols(), T(0));
+            for (size_t i = 0; i < r.rows(); ++i) {
+                for (size_t j = 0; j < r.cols(); ++j) {
+                    for (size_t k = 0; k < a.cols(); ++k) {
+                        r(i, j) += a(i, k) * b(k, j);
+                    }
+                }
+            }
+
+            BOOST_CHECK(a * b == r);
+
+            a *= b;
+            BOOST_CHECK(a == r);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(Multiplication) {
+        dispatchTest(testMultiplication);
+    }
+
+    template<class M>
+    void testMatrixVector() {
+        typedef typename M::value_type T;
+
+        {
+            M a = {{1, 2, 3},
+                   {4, 5, 6}};
+            const std::vector<T> x = {1, -1, 2};
+            const std::vector<T> r = {5, 11};
+
+            BOOST_CHECK(a * x == r);
+
+            std::vector<T> y;
+            anpi::multiplicateTransposed(a, r, y);
+            BOOST_CHECK(y == std::vector<T>({49, 65, 81}));
+
+            BOOST_CHECK_THROW(anpi::multiplicate(a, r, y), anpi::Exception);
+            BOOST_CHECK_THROW(anpi::multiplicateTransposed(a, x, y), anpi::Exception);
+        }
+
+        // Sizes with and without whole registers and groups of rows. The
+        // entries are small integers, so the products are exact
+        const std::vector<std::pair<size_t, size_t> > sizes =
+                {{1, 1}, {3, 5}, {4, 8}, {7, 13}, {33, 70}, {130, 2100}, {2100, 37}};
+
+        for (const std::pair<size_t, size_t> &size : sizes) {
+            M a(size.first, size.second, anpi::DoNotInitialize);
+            for (size_t i = 0; i < a.rows(); ++i) {
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    a(i, j) = T(int((i + 2 * j) % 7) - 3);
+                }
+            }
+
+            std::vector<T> x(a.cols());
+            for (size_t j = 0; j < x.size(); ++j) {
+                x[j] = T(int(j % 5) - 2);
+            }
+            std::vector<T> u(a.rows());
+            for (size_t i = 0; i < u.size(); ++i) {
+                u[i] = T(int(i % 3) - 1);
+            }
+
+            std::vector<T> r(a.rows(), T(0));
+            std::vector<T> rt(a.cols(), T(0));
+            for (size_t i = 0; i < a.rows(); ++i) {
+                for (size_t j = 0; j < a.cols(); ++j) {
+                    r[i] += a(i, j) * x[j];
+                    rt[j] += a(i, j) * u[i];
+                }
+            }
+
+            BOOST_CHECK(a * x == r);
+
+            // The output of the caller is reused
+            std::vector<T> y(a.rows(), T(7));
+            anpi::multiplicate(a, x, y);
+            BOOST_CHECK(y == r);
+
+            anpi::multiplicateTransposed(a, u, y);
+            BOOST_CHECK(y == rt);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(MatrixVector) {
+        dispatchTest(testMatrixVector);
+    }
+
+    BOOST_AUTO_TEST_CASE(PingPong) {
+        anpi::Matrix<double> a = {{1, 2, 3},
+                                  {4, 5, 6}};
+
+        anpi::PingPong<double> grids(a);
+        BOOST_CHECK(grids.front() == a);
+        BOOST_CHECK(grids.back() == a);
+
+        // The swap exchanges the grids without copying them
+        const double *frontData = grids.front().data();
+        const double *backData = grids.back().data();
+        grids.back()(0, 0) = 7;
+        grids.swap();
+
+        BOOST_CHECK(grids.front().data() == backData);
+        BOOST_CHECK(grids.back().data() == frontData);
+        BOOST_CHECK(grids.front()(0, 0) == 7);
+        BOOST_CHECK(grids.back()(0, 0) == 1);
+
+        anpi::Matrix<double> result = grids.release();
+        BOOST_CHECK(result.data() == backData);
+        BOOST_CHECK(result(0, 0) == 7);
+    }
+
+    /// Every 16 bit pattern read and written back by the SIMD helpers
+    template<typename S>
+    void testStorageRoundTrip() {
+#ifdef __AVX__
+        typedef typename avx_traits<S>::reg_type regType;
+        const size_t step = sizeof(regType) / sizeof(float);
+
+        std::vector<S> patterns(65536), copy(65536);
+        for (size_t k = 0; k < patterns.size(); ++k) {
+            patterns[k].bits = std::uint16_t(k);
+        }
+        for (size_t k = 0; k < patterns.size(); k += step) {
+            mm_storeRegisteru<S>(&copy[k], mm_loadRegisteru<S, regType>(&patterns[k]));
+        }
+
+        for (size_t k = 0; k < patterns.size(); ++k) {
+            const float value = patterns[k];
+            if (value == value) {
+                BOOST_CHECK(copy[k].bits == patterns[k].bits);
+            } else {
+                BOOST_CHECK(float(copy[k]) != float(copy[k]));
+            }
+        }
+#endif
+    }
+
+    BOOST_AUTO_TEST_CASE(HalfPrecision) {
+        // Exact values and rounding to the nearest even
+        BOOST_CHECK(float(anpi::bfloat16(1.f)) == 1.f);
+        BOOST_CHECK(float(anpi::bfloat16(1.f + 1.f / 256)) == 1.f);
+        BOOST_CHECK(float(anpi::bfloat16(1.f + 3.f / 256)) == 1.f + 1.f / 64);
+        BOOST_CHECK(float(anpi::bfloat16(-250.f)) == -250.f);
+        BOOST_CHECK(float(anpi::bfloat16(3e38f)) > 2.9e38f);
+
+        BOOST_CHECK(float(anpi::half(1.f)) == 1.f);
+        BOOST_CHECK(float(anpi::half(1.f + 1.f / 2048)) == 1.f);
+        BOOST_CHECK(float(anpi::half(1.f + 3.f / 2048)) == 1.f + 1.f / 512);
+        BOOST_CHECK(float(anpi::half(65504.f)) == 65504.f);
+        BOOST_CHECK(float(anpi::half(-250.f)) == -250.f);
+
+        // Overflow, subnormals and NaN
+        BOOST_CHECK(float(anpi::half(70000.f)) == std::numeric_limits<float>::infinity());
+        BOOST_CHECK(float(anpi::half(5.9604644775390625e-8f)) == 5.9604644775390625e-8f);
+        BOOST_CHECK(float(anpi::half(1e-9f)) == 0.f);
+
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        BOOST_CHECK(float(anpi::bfloat16(nan)) != float(anpi::bfloat16(nan)));
+        BOOST_CHECK(float(anpi::half(nan)) != float(anpi::half(nan)));
+
+#ifdef __AVX2__
+        testStorageRoundTrip<anpi::bfloat16>();
+#endif
+#ifdef __F16C__
+        testStorageRoundTrip<anpi::half>();
+#endif
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+/**
+ * Copyright (C) 2017
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <complex>
+#include <chrono>
+
+
+/**
+ * Unit tests for the multigrid solver
+ */
+
+#include "Matrix.hpp"
+#include "Multigrid.hpp"
+#include "Allocator.hpp"
+#include "PlateFixture.hpp"
+
+
+BOOST_AUTO_TEST_SUITE(MultigridImplementation)
+
+
+    BOOST_AUTO_TEST_CASE(MatchesSOR) {
+        std::vector<anpi::MultigridCycle> cycles = {anpi::MultigridCycle::V, anpi::MultigridCycle::W};
+        std::vector<anpi::MultigridSmoother> smoothers = {anpi::MultigridSmoother::RedBlackGaussSeidel,
+                                                          anpi::MultigridSmoother::Jacobi};
+
+        anpi::test::compareWithSOR([&](anpi::Matrix<double> &borders,
+                                       const size_t rows,
+                                       const size_t cols,
+                                       const std::vector<bool> &bordersIsolation,
+                                       const anpi::Matrix<double> &expected) {
+            for (const auto cycle : cycles) {
+                for (const auto smoother : smoothers) {
+                    anpi::MultigridOptions options;
+                    options.cycle = cycle;
+                    options.smoother = smoother;
+                    options.tolerance = 1e-10;
+
+                    anpi::Matrix<double> b = anpi::initializePlate(borders, rows, cols, bordersIsolation);
+                    const size_t usedCycles = anpi::multigridAux(b, bordersIsolation, options);
+
+                    // A handful of cycles, independent of the plate size
+                    BOOST_CHECK(usedCycles < 30);
+                    BOOST_CHECK(anpi::test::innerDifference(b, expected) < 1e-6);
+                }
+            }
+        });
+    }
+
+    /// Largest difference between a plate stored in S and the reference plate
+    template<typename S>
+    double compressedError(const anpi::Matrix<double> &expected,
+                           const std::vector<bool> &bordersIsolation,
+                           const anpi::MultigridSmoother smoother) {
+        anpi::Matrix<float> borders = anpi::test::plateBorders<float>();
+
+        anpi::MultigridOptions options;
+        options.smoother = smoother;
+        options.tolerance = 1e-6;
+
+        anpi::Matrix<S, anpi::aligned_row_allocator<S> > b =
+                anpi::compressedMultigrid<S>(borders, expected.rows() - 2, expected.cols() - 2,
+                                             bordersIsolation, options);
+
+        BOOST_CHECK(b.rows() == expected.rows() && b.cols() == expected.cols());
+
+        return anpi::test::innerDifference(b, expected);
+    }
+
+    BOOST_AUTO_TEST_CASE(CompressedStorage) {
+        anpi::Matrix<double> borders = anpi::test::plateBorders();
+        const anpi::LiebmannOptions sorOptions = anpi::test::sorOptions();
+
+        std::vector<std::vector<bool> > isolations = {{false, false, false, false},
+                                                      {false, false, true,  true}};
+        std::vector<anpi::MultigridSmoother> smoothers = {anpi::MultigridSmoother::RedBlackGaussSeidel,
+                                                          anpi::MultigridSmoother::Jacobi};
+
+        for (const auto &bordersIsolation : isolations) {
+            anpi::Matrix<double> expected = liebmann(borders, 60, 90, bordersIsolation, 1., true, sorOptions);
+
+            // The error is bound by the rounding of the storage at 250
+            for (const auto smoother : smoothers) {
+                BOOST_CHECK(compressedError<anpi::bfloat16>(expected, bordersIsolation, smoother) < 4.);
+                BOOST_CHECK(compressedError<anpi::half>(expected, bordersIsolation, smoother) < 0.8);
+            }
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(Multigrid) {
+        anpi::Matrix<double> borders = anpi::test::plateBorders(1000);
+
+        std::vector<bool> bordersIsolation = {false, false, false, false};
+
+        std::cout << "Starting Multigrid test..." << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+
+        anpi::Matrix<double> b = multigrid(borders, 1000, 1000, bordersIsolation);
+
+        auto end = std::chrono::steady_clock::now();
+        std::cout << "Finished Multigrid test in " << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+        BOOST_CHECK(b.rows() == 1002 && b.cols() == 1002);
+    }
+
+
+BOOST_AUTO_TEST_SUITE_END()
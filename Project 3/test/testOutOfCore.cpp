@@ -0,0 +1,108 @@
+/**
+ * Copyright (C) 2017
+ * Área Académica de Ingeniería en Computadoras, TEC, Costa Rica
+ *
+ * This file is part of the CE3102 Numerical Analysis lecture at TEC
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cmath>
+
+
+/**
+ * Unit tests for the out-of-core Liebmann method
+ */
+
+#include "Matrix.hpp"
+#include "OutOfCore.hpp"
+#include "Allocator.hpp"
+#include "PlateFixture.hpp"
+
+
+namespace fs = boost::filesystem;
+
+BOOST_AUTO_TEST_SUITE(OutOfCoreImplementation)
+
+
+    BOOST_AUTO_TEST_CASE(PipelinedSweeps) {
+        anpi::Matrix<double> borders = anpi::test::plateBorders(60);
+        const fs::path path = fs::temp_directory_path() / fs::unique_path();
+
+        std::vector<size_t> sweeps = {1, 2, 5, 16};
+
+        for (const auto &bordersIsolation : anpi::test::isolations()) {
+            for (const size_t k : sweeps) {
+                anpi::Matrix<double> expected = anpi::initializePlate(borders, 37, 53, bordersIsolation);
+
+                anpi::mmap_allocator<double> allocator(path.string());
+                anpi::Matrix<double, anpi::mmap_allocator<double> > plate(expected.rows(), expected.cols(),
+                                                                          anpi::DoNotInitialize, allocator);
+                for (size_t i = 0; i < plate.rows(); ++i) {
+                    std::copy(expected[i], expected[i] + expected.cols(), plate[i]);
+                }
+
+                const anpi::StencilWeights<double> weights = anpi::isolationWeights<double>(bordersIsolation);
+                const double omega = anpi::optimalOmega<double>(plate.rows(), plate.cols(), bordersIsolation);
+
+                // A pass of k sweeps updates every pixel as k sweeps in memory
+                for (size_t pass = 0; pass < 3; ++pass) {
+                    anpi::UpdateNorms<double> last;
+                    for (size_t s = 0; s < k; ++s) {
+                        last = anpi::redBlackSweep(expected, weights, omega);
+                    }
+                    const anpi::UpdateNorms<double> norms = anpi::streamingPass(plate, allocator, weights, omega,
+                                                                                k, 4);
+                    BOOST_CHECK(norms.max == last.max);
+
+                    bool equal = true;
+                    for (size_t i = 0; i < plate.rows(); ++i) {
+                        for (size_t j = 0; j < plate.cols(); ++j) {
+                            equal = equal && plate(i, j) == expected(i, j);
+                        }
+                    }
+                    BOOST_CHECK(equal);
+                }
+            }
+        }
+
+        fs::remove(path);
+    }
+
+
+    BOOST_AUTO_TEST_CASE(MatchesSOR) {
+        const fs::path path = fs::temp_directory_path() / fs::unique_path();
+
+        // Without a coarse solution, from a coarser one and from one of the plate size
+        std::vector<size_t> coarsePixels = {0, 500, 10000};
+
+        anpi::test::compareWithSOR(anpi::test::isolations(), {{60, 90}}, [&](anpi::Matrix<double> &borders,
+                                                                              const size_t rows,
+                                                                              const size_t cols,
+                                                                              const std::vector<bool> &bordersIsolation,
+                                                                              const anpi::Matrix<double> &expected) {
+            for (const size_t pixels : coarsePixels) {
+                anpi::StreamingOptions options;
+                options.bandRows = 8;
+                options.tolerance = 1e-10;
+                options.coarsePixels = pixels;
+
+                anpi::Matrix<double, anpi::mmap_allocator<double> > plate =
+                        anpi::streamingLiebmann(path.string(), borders, rows, cols, bordersIsolation, options);
+
+                BOOST_CHECK(plate.rows() == expected.rows() && plate.cols() == expected.cols());
+                BOOST_CHECK(anpi::test::innerDifference(plate, expected) < 1e-6);
+            }
+        });
+
+        // The plate stays in the file
+        BOOST_CHECK(fs::file_size(path) >= 62 * 92 * sizeof(double));
+        fs::remove(path);
+    }
+
+
+BOOST_AUTO_TEST_SUITE_END()